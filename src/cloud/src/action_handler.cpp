@@ -6,11 +6,14 @@
 #include <rcl_cloud_process_response.h>
 
 #include "action_handler.h"
+#include "file_condition.h"
+#include "server_action.h"
 
 ActionHandler::ActionHandler(UserManager *userManager,
                              ActionManager *actionManager,
                              ProcessManager *processManager,
                              FileManager *fileManager,
+                             FileScrubber *fileScrubber,
                              ReportManager *reportManager,
                              Mailer *mailer,
                              QObject *parent)
@@ -19,6 +22,7 @@ ActionHandler::ActionHandler(UserManager *userManager,
     , actionManager{actionManager}
     , processManager{processManager}
     , fileManager{fileManager}
+    , fileScrubber{fileScrubber}
     , reportManager{reportManager}
     , mailer{mailer}
 {
@@ -78,6 +82,7 @@ void ActionHandler::resolveAction(const RCloudAction &action, const QString &fro
     else if (action.getAction() == RCloudAction::Action::ListFiles::key)
     {
         FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
 
         QUuid requestId = this->fileManager->requestListFiles(executorInfo,fileObject);
         this->fileRequests.insert(requestId,action.getId());
@@ -86,6 +91,7 @@ void ActionHandler::resolveAction(const RCloudAction &action, const QString &fro
     {
         FileObject *fileObject = new FileObject;
         fileObject->getInfo().setId(action.getResourceId());
+        fileObject->setContent(action.getData());
 
         QUuid requestId = this->fileManager->requestFileInfo(executorInfo,fileObject);
         this->fileRequests.insert(requestId,action.getId());
@@ -202,6 +208,7 @@ void ActionHandler::resolveAction(const RCloudAction &action, const QString &fro
     {
         FileObject *fileObject = new FileObject;
         fileObject->getInfo().setId(action.getResourceId());
+        fileObject->setContent(action.getData());
 
         QUuid requestId = this->fileManager->requestRetrieveFile(executorInfo,fileObject);
         this->fileRequests.insert(requestId,action.getId());
@@ -214,6 +221,142 @@ void ActionHandler::resolveAction(const RCloudAction &action, const QString &fro
         QUuid requestId = this->fileManager->requestRemoveFile(executorInfo,fileObject);
         this->fileRequests.insert(requestId,action.getId());
     }
+    else if (action.getAction() == ServerAction::FileUploadOpen::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->getInfo().setPath(action.getResourceName());
+        fileObject->getInfo().setId(action.getResourceId());
+
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestOpenUploadSession(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileUploadChunk::key)
+    {
+        FileObject *fileObject = new FileObject;
+        // Resource ID is session ID and resource name is chunk index.
+        fileObject->getInfo().setId(action.getResourceId());
+        fileObject->getInfo().setPath(action.getResourceName());
+
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestStoreUploadChunk(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileUploadStatus::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->getInfo().setId(action.getResourceId());
+
+        QUuid requestId = this->fileManager->requestUploadSessionStatus(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileUploadCommit::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->getInfo().setId(action.getResourceId());
+
+        RAccessOwner accessOwner;
+        accessOwner.setUser(executorInfo.getName());
+        accessOwner.setGroup(RUserInfo::userGroup);
+
+        RAccessMode accessMode;
+        accessMode.setUserModeMask(RAccessMode::Mode::Read | RAccessMode::Mode::Write);
+        accessMode.setGroupModeMask(RAccessMode::Mode::Read);
+        accessMode.setOtherModeMask(RAccessMode::Mode::None);
+
+        RAccessRights accessRights;
+        accessRights.setOwner(accessOwner);
+        accessRights.setMode(accessMode);
+
+        fileObject->getInfo().setAccessRights(accessRights);
+
+        QUuid requestId = this->fileManager->requestCommitUploadSession(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileUploadAbort::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->getInfo().setId(action.getResourceId());
+
+        QUuid requestId = this->fileManager->requestAbortUploadSession(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileBatchRemove::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestBatchRemoveFiles(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileBatchUpdateAccessMode::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestBatchUpdateFileAccessMode(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileBatchUpdateVersion::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestBatchUpdateFileVersion(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileBatchUpdateTags::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestBatchUpdateFileTags(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileDownloadArchive::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestRetrieveArchive(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileUploadArchive::key)
+    {
+        FileObject *fileObject = new FileObject;
+        // Resource name is path prefix of archive members.
+        fileObject->getInfo().setPath(action.getResourceName());
+
+        RAccessOwner accessOwner;
+        accessOwner.setUser(executorInfo.getName());
+        accessOwner.setGroup(RUserInfo::userGroup);
+
+        RAccessMode accessMode;
+        accessMode.setUserModeMask(RAccessMode::Mode::Read | RAccessMode::Mode::Write);
+        accessMode.setGroupModeMask(RAccessMode::Mode::Read);
+        accessMode.setOtherModeMask(RAccessMode::Mode::None);
+
+        RAccessRights accessRights;
+        accessRights.setOwner(accessOwner);
+        accessRights.setMode(accessMode);
+
+        fileObject->getInfo().setAccessRights(accessRights);
+
+        fileObject->setContent(action.getData());
+
+        QUuid requestId = this->fileManager->requestStoreArchive(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
+    else if (action.getAction() == ServerAction::FileMd5Checksum::key)
+    {
+        FileObject *fileObject = new FileObject;
+        fileObject->getInfo().setId(action.getResourceId());
+
+        QUuid requestId = this->fileManager->requestFileMd5Checksum(executorInfo,fileObject);
+        this->fileRequests.insert(requestId,action.getId());
+    }
     else if (action.getAction() == RCloudAction::Action::Stop::key)
     {
         RCloudAction resolvedAction(action);
@@ -240,6 +383,7 @@ void ActionHandler::resolveAction(const RCloudAction &action, const QString &fro
         RLogger::indent();
         QJsonArray jServicesArray;
         jServicesArray.append(this->fileManager->getStatisticsJson());
+        jServicesArray.append(this->fileScrubber->getStatisticsJson());
         jServicesArray.append(this->actionManager->getStatisticsJson());
         jServicesArray.append(this->processManager->getStatisticsJson());
         jServicesArray.append(this->reportManager->getStatisticsJson());
@@ -861,7 +1005,7 @@ void ActionHandler::onFileRequestCompleted(const QUuid &requestId, QSharedPointe
                        object->getInfo().getPath(),
                        object->getInfo().getId(),
                        object->getContent());
-        action.setErrorType(object->getErrorType());
+        action.setErrorType(object->isNotModified() ? FileCondition::notModifiedErrorType : object->getErrorType());
         this->fileRequests.remove(requestId);
         emit this->resolved(action);
     }
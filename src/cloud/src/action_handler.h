@@ -9,6 +9,7 @@
 
 #include "action_manager.h"
 #include "file_manager.h"
+#include "file_scrubber.h"
 #include "mailer.h"
 #include "process_manager.h"
 #include "report_manager.h"
@@ -29,6 +30,8 @@ class ActionHandler : public QObject
         ProcessManager *processManager;
         //! Pointer to file manager.
         FileManager *fileManager;
+        //! Pointer to file scrubber.
+        FileScrubber *fileScrubber;
         //! Pointer to report manager.
         ReportManager *reportManager;
         //! Pointer to mailer.
@@ -46,6 +49,7 @@ class ActionHandler : public QObject
                                ActionManager *actionManager,
                                ProcessManager *processManager,
                                FileManager *fileManager,
+                               FileScrubber *fileScrubber,
                                ReportManager *reportManager,
                                Mailer *mailer,
                                QObject *parent = nullptr);
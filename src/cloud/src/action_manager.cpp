@@ -8,6 +8,7 @@
 #include <rbl_logger.h>
 
 #include "action_manager.h"
+#include "server_action.h"
 
 ActionManager::ActionManager(const ActionManagerSettings &settings, QObject *parent)
     : QObject{parent}
@@ -27,6 +28,7 @@ ActionManager::ActionManager(const ActionManagerSettings &settings, QObject *par
     }
 
     QMap<QString,QString> actionMap = RCloudAction::getActionMap();
+    actionMap.insert(ServerAction::getActionMap());
     for (auto iter = actionMap.cbegin(); iter != actionMap.cend(); ++iter)
     {
         const QString &actionName = iter.key();
@@ -44,6 +44,7 @@ Application::Application(int &argc, char **argv) :
     publicHttpServer(nullptr),
     privateHttpServer(nullptr),
     fileManager(nullptr),
+    fileScrubber(nullptr),
     mailer(nullptr),
     actionHandler(nullptr),
     nStartedServices(0)
@@ -73,6 +74,7 @@ Application::~Application()
 {
     delete this->publicHttpServer;
     delete this->privateHttpServer;
+    delete this->fileScrubber;
     delete this->fileManager;
     delete this->mailer;
 }
@@ -342,6 +344,26 @@ void Application::onStarted()
         fileManagerSettings.setFileStore(configuration.getFileStore());
         fileManagerSettings.setMaxStoreSize(configuration.getFileStoreMaxSize());
         fileManagerSettings.setMaxFileSize(configuration.getFileStoreMaxFileSize());
+        fileManagerSettings.setReaderCount(configuration.getFileStoreReaders());
+        fileManagerSettings.setJournalLimit(configuration.getFileStoreJournalLimit());
+        fileManagerSettings.setReadBufferSize(configuration.getFileStoreReadBufferSize());
+        fileManagerSettings.setWriteBufferSize(configuration.getFileStoreWriteBufferSize());
+        fileManagerSettings.setDeduplicate(configuration.getFileStoreDeduplicate());
+        fileManagerSettings.setCompression(configuration.getFileStoreCompression());
+        fileManagerSettings.setCacheSize(configuration.getFileStoreCacheSize());
+        fileManagerSettings.setCacheMaxFileSize(configuration.getFileStoreCacheMaxFileSize());
+        fileManagerSettings.setShardLevels(configuration.getFileStoreShardLevels());
+        fileManagerSettings.setDurability(configuration.getFileStoreDurability());
+        fileManagerSettings.setGroupCommitWindow(configuration.getFileStoreGroupCommitWindow());
+        fileManagerSettings.setJournalFlushInterval(configuration.getFileStoreJournalFlushInterval());
+        fileManagerSettings.setJournalFlushCount(configuration.getFileStoreJournalFlushCount());
+        fileManagerSettings.setArchiveMaxSize(configuration.getFileStoreArchiveMaxSize());
+        fileManagerSettings.setScrubBandwidth(configuration.getFileStoreScrubBandwidth());
+        fileManagerSettings.setScrubInterval(configuration.getFileStoreScrubInterval());
+        fileManagerSettings.setChecksum(configuration.getFileStoreChecksum());
+        fileManagerSettings.setRetrieveMaxSize(configuration.getFileStoreRetrieveMaxSize());
+        fileManagerSettings.setUploadSessionTimeout(configuration.getFileStoreUploadSessionTimeout());
+        fileManagerSettings.setArchiveMemoryLimit(configuration.getFileStoreArchiveMemoryLimit());
 
         this->fileManager = new FileManager(fileManagerSettings,this->userManager);
         QObject::connect(this->fileManager, &FileManager::ready, this, &Application::fileServiceReady);
@@ -349,6 +371,9 @@ void Application::onStarted()
         QObject::connect(this->fileManager, &FileManager::finished, this, &Application::fileServiceFinished);
         QObject::connect(this->fileManager, &FileManager::failed, this, &Application::fileServiceFailed);
 
+        // File scrubber runs in background and is not counted among services.
+        this->fileScrubber = new FileScrubber(fileManagerSettings,this->fileManager);
+
         // Report manager service
         ReportManagerSettings reportManagerSettings;
         reportManagerSettings.setReportDirectory(configuration.getReportsDirectoryPath());
@@ -411,12 +436,14 @@ void Application::onStarted()
                                                 this->actionManager,
                                                 this->processManager,
                                                 this->fileManager,
+                                                this->fileScrubber,
                                                 this->reportManager,
                                                 this->mailer,
                                                 this);
         QObject::connect(this->actionHandler, &ActionHandler::resolved, this, &Application::actionResolved);
 
         RJobManager::getInstance().submit(this->fileManager);
+        RJobManager::getInstance().submit(this->fileScrubber);
         RJobManager::getInstance().submit(this->mailer);
 
         QObject::connect(new UnixSignalHandler(SIGTERM, this), &UnixSignalHandler::raised, this, &Application::shutdown);
@@ -642,6 +669,7 @@ void Application::actionResolved(const RCloudAction &action)
 void Application::shutdown()
 {
     R_LOG_TRACE_IN;
+    this->fileScrubber->stop();
     this->fileManager->stop();
     this->mailer->stop();
     this->publicHttpServer->stop();
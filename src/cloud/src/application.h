@@ -70,6 +70,9 @@ class Application : public QCoreApplication
         //! File service is ready.
         bool fileServiceIsReady;
 
+        //! File scrubber.
+        FileScrubber *fileScrubber;
+
         //! Mailer.
         Mailer *mailer;
         //! Mailer service is ready.
@@ -12,6 +12,7 @@
 #include <rcl_report_record.h>
 
 #include "configuration.h"
+#include "file_sync.h"
 
 const QString Configuration::cloudDirectoryBase = "range-cloud";
 const QString Configuration::rangeCaDirectoryBase = "range-ca";
@@ -48,6 +49,26 @@ void Configuration::_init(const Configuration *pConfiguration)
         this->fileStore = pConfiguration->fileStore;
         this->fileStoreMaxSize = pConfiguration->fileStoreMaxSize;
         this->fileStoreMaxFileSize = pConfiguration->fileStoreMaxFileSize;
+        this->fileStoreReaders = pConfiguration->fileStoreReaders;
+        this->fileStoreJournalLimit = pConfiguration->fileStoreJournalLimit;
+        this->fileStoreReadBufferSize = pConfiguration->fileStoreReadBufferSize;
+        this->fileStoreWriteBufferSize = pConfiguration->fileStoreWriteBufferSize;
+        this->fileStoreDeduplicate = pConfiguration->fileStoreDeduplicate;
+        this->fileStoreCompression = pConfiguration->fileStoreCompression;
+        this->fileStoreCacheSize = pConfiguration->fileStoreCacheSize;
+        this->fileStoreCacheMaxFileSize = pConfiguration->fileStoreCacheMaxFileSize;
+        this->fileStoreShardLevels = pConfiguration->fileStoreShardLevels;
+        this->fileStoreDurability = pConfiguration->fileStoreDurability;
+        this->fileStoreGroupCommitWindow = pConfiguration->fileStoreGroupCommitWindow;
+        this->fileStoreJournalFlushInterval = pConfiguration->fileStoreJournalFlushInterval;
+        this->fileStoreJournalFlushCount = pConfiguration->fileStoreJournalFlushCount;
+        this->fileStoreArchiveMaxSize = pConfiguration->fileStoreArchiveMaxSize;
+        this->fileStoreScrubBandwidth = pConfiguration->fileStoreScrubBandwidth;
+        this->fileStoreScrubInterval = pConfiguration->fileStoreScrubInterval;
+        this->fileStoreChecksum = pConfiguration->fileStoreChecksum;
+        this->fileStoreRetrieveMaxSize = pConfiguration->fileStoreRetrieveMaxSize;
+        this->fileStoreUploadSessionTimeout = pConfiguration->fileStoreUploadSessionTimeout;
+        this->fileStoreArchiveMemoryLimit = pConfiguration->fileStoreArchiveMemoryLimit;
         this->maxReportLength = pConfiguration->maxReportLength;
         this->maxCommentLength = pConfiguration->maxCommentLength;
         this->senderEmailAddress = pConfiguration->senderEmailAddress;
@@ -68,6 +89,26 @@ Configuration::Configuration(const QString &cloudDirectory)
     , fileStore{Configuration::getDefaultFileStorePath(this->cloudDirectory)}
     , fileStoreMaxSize{Configuration::getDefaultFileStoreMaxSize()}
     , fileStoreMaxFileSize{Configuration::getDefaultFileStoreMaxFileSize()}
+    , fileStoreReaders{Configuration::getDefaultFileStoreReaders()}
+    , fileStoreJournalLimit{Configuration::getDefaultFileStoreJournalLimit()}
+    , fileStoreReadBufferSize{Configuration::getDefaultFileStoreReadBufferSize()}
+    , fileStoreWriteBufferSize{Configuration::getDefaultFileStoreWriteBufferSize()}
+    , fileStoreDeduplicate{Configuration::getDefaultFileStoreDeduplicate()}
+    , fileStoreCompression{Configuration::getDefaultFileStoreCompression()}
+    , fileStoreCacheSize{Configuration::getDefaultFileStoreCacheSize()}
+    , fileStoreCacheMaxFileSize{Configuration::getDefaultFileStoreCacheMaxFileSize()}
+    , fileStoreShardLevels{Configuration::getDefaultFileStoreShardLevels()}
+    , fileStoreDurability{Configuration::getDefaultFileStoreDurability()}
+    , fileStoreGroupCommitWindow{Configuration::getDefaultFileStoreGroupCommitWindow()}
+    , fileStoreJournalFlushInterval{Configuration::getDefaultFileStoreJournalFlushInterval()}
+    , fileStoreJournalFlushCount{Configuration::getDefaultFileStoreJournalFlushCount()}
+    , fileStoreArchiveMaxSize{Configuration::getDefaultFileStoreArchiveMaxSize()}
+    , fileStoreScrubBandwidth{Configuration::getDefaultFileStoreScrubBandwidth()}
+    , fileStoreScrubInterval{Configuration::getDefaultFileStoreScrubInterval()}
+    , fileStoreChecksum{Configuration::getDefaultFileStoreChecksum()}
+    , fileStoreRetrieveMaxSize{Configuration::getDefaultFileStoreRetrieveMaxSize()}
+    , fileStoreUploadSessionTimeout{Configuration::getDefaultFileStoreUploadSessionTimeout()}
+    , fileStoreArchiveMemoryLimit{Configuration::getDefaultFileStoreArchiveMemoryLimit()}
     , maxReportLength{Configuration::getDefaultMaxReportLength()}
     , maxCommentLength{Configuration::getDefaultMaxCommentLength()}
     , senderEmailAddress{Configuration::getDefaultSenderEmailAddress()}
@@ -215,6 +256,206 @@ void Configuration::setFileStoreMaxFileSize(qint64 fileStoreMaxFileSize)
     this->fileStoreMaxFileSize = fileStoreMaxFileSize;
 }
 
+uint Configuration::getFileStoreReaders() const
+{
+    return this->fileStoreReaders;
+}
+
+void Configuration::setFileStoreReaders(uint fileStoreReaders)
+{
+    this->fileStoreReaders = fileStoreReaders;
+}
+
+qint64 Configuration::getFileStoreJournalLimit() const
+{
+    return this->fileStoreJournalLimit;
+}
+
+void Configuration::setFileStoreJournalLimit(qint64 fileStoreJournalLimit)
+{
+    this->fileStoreJournalLimit = fileStoreJournalLimit;
+}
+
+qint64 Configuration::getFileStoreReadBufferSize() const
+{
+    return this->fileStoreReadBufferSize;
+}
+
+void Configuration::setFileStoreReadBufferSize(qint64 fileStoreReadBufferSize)
+{
+    this->fileStoreReadBufferSize = fileStoreReadBufferSize;
+}
+
+qint64 Configuration::getFileStoreWriteBufferSize() const
+{
+    return this->fileStoreWriteBufferSize;
+}
+
+void Configuration::setFileStoreWriteBufferSize(qint64 fileStoreWriteBufferSize)
+{
+    this->fileStoreWriteBufferSize = fileStoreWriteBufferSize;
+}
+
+bool Configuration::getFileStoreDeduplicate() const
+{
+    return this->fileStoreDeduplicate;
+}
+
+void Configuration::setFileStoreDeduplicate(bool fileStoreDeduplicate)
+{
+    this->fileStoreDeduplicate = fileStoreDeduplicate;
+}
+
+const QString &Configuration::getFileStoreCompression() const
+{
+    return this->fileStoreCompression;
+}
+
+void Configuration::setFileStoreCompression(const QString &fileStoreCompression)
+{
+    this->fileStoreCompression = fileStoreCompression;
+}
+
+qint64 Configuration::getFileStoreCacheSize() const
+{
+    return this->fileStoreCacheSize;
+}
+
+void Configuration::setFileStoreCacheSize(qint64 fileStoreCacheSize)
+{
+    this->fileStoreCacheSize = fileStoreCacheSize;
+}
+
+qint64 Configuration::getFileStoreCacheMaxFileSize() const
+{
+    return this->fileStoreCacheMaxFileSize;
+}
+
+void Configuration::setFileStoreCacheMaxFileSize(qint64 fileStoreCacheMaxFileSize)
+{
+    this->fileStoreCacheMaxFileSize = fileStoreCacheMaxFileSize;
+}
+
+uint Configuration::getFileStoreShardLevels() const
+{
+    return this->fileStoreShardLevels;
+}
+
+void Configuration::setFileStoreShardLevels(uint fileStoreShardLevels)
+{
+    this->fileStoreShardLevels = fileStoreShardLevels;
+}
+
+const QString &Configuration::getFileStoreDurability() const
+{
+    return this->fileStoreDurability;
+}
+
+void Configuration::setFileStoreDurability(const QString &fileStoreDurability)
+{
+    this->fileStoreDurability = fileStoreDurability;
+}
+
+uint Configuration::getFileStoreGroupCommitWindow() const
+{
+    return this->fileStoreGroupCommitWindow;
+}
+
+void Configuration::setFileStoreGroupCommitWindow(uint fileStoreGroupCommitWindow)
+{
+    this->fileStoreGroupCommitWindow = fileStoreGroupCommitWindow;
+}
+
+uint Configuration::getFileStoreJournalFlushInterval() const
+{
+    return this->fileStoreJournalFlushInterval;
+}
+
+void Configuration::setFileStoreJournalFlushInterval(uint fileStoreJournalFlushInterval)
+{
+    this->fileStoreJournalFlushInterval = fileStoreJournalFlushInterval;
+}
+
+uint Configuration::getFileStoreJournalFlushCount() const
+{
+    return this->fileStoreJournalFlushCount;
+}
+
+void Configuration::setFileStoreJournalFlushCount(uint fileStoreJournalFlushCount)
+{
+    this->fileStoreJournalFlushCount = fileStoreJournalFlushCount;
+}
+
+qint64 Configuration::getFileStoreArchiveMaxSize() const
+{
+    return this->fileStoreArchiveMaxSize;
+}
+
+void Configuration::setFileStoreArchiveMaxSize(qint64 fileStoreArchiveMaxSize)
+{
+    this->fileStoreArchiveMaxSize = fileStoreArchiveMaxSize;
+}
+
+qint64 Configuration::getFileStoreScrubBandwidth() const
+{
+    return this->fileStoreScrubBandwidth;
+}
+
+void Configuration::setFileStoreScrubBandwidth(qint64 fileStoreScrubBandwidth)
+{
+    this->fileStoreScrubBandwidth = fileStoreScrubBandwidth;
+}
+
+uint Configuration::getFileStoreScrubInterval() const
+{
+    return this->fileStoreScrubInterval;
+}
+
+void Configuration::setFileStoreScrubInterval(uint fileStoreScrubInterval)
+{
+    this->fileStoreScrubInterval = fileStoreScrubInterval;
+}
+
+const QString &Configuration::getFileStoreChecksum() const
+{
+    return this->fileStoreChecksum;
+}
+
+void Configuration::setFileStoreChecksum(const QString &fileStoreChecksum)
+{
+    this->fileStoreChecksum = fileStoreChecksum;
+}
+
+qint64 Configuration::getFileStoreRetrieveMaxSize() const
+{
+    return this->fileStoreRetrieveMaxSize;
+}
+
+void Configuration::setFileStoreRetrieveMaxSize(qint64 fileStoreRetrieveMaxSize)
+{
+    this->fileStoreRetrieveMaxSize = fileStoreRetrieveMaxSize;
+}
+
+uint Configuration::getFileStoreUploadSessionTimeout() const
+{
+    return this->fileStoreUploadSessionTimeout;
+}
+
+void Configuration::setFileStoreUploadSessionTimeout(uint fileStoreUploadSessionTimeout)
+{
+    this->fileStoreUploadSessionTimeout = fileStoreUploadSessionTimeout;
+}
+
+qint64 Configuration::getFileStoreArchiveMemoryLimit() const
+{
+    return this->fileStoreArchiveMemoryLimit;
+}
+
+void Configuration::setFileStoreArchiveMemoryLimit(qint64 fileStoreArchiveMemoryLimit)
+{
+    this->fileStoreArchiveMemoryLimit = fileStoreArchiveMemoryLimit;
+}
+
 qint64 Configuration::getMaxReportLength() const
 {
     return this->maxReportLength;
@@ -369,6 +610,86 @@ void Configuration::fromJson(const QJsonObject &json)
     {
         this->fileStoreMaxFileSize = v.toString().toLongLong();
     }
+    if (const QJsonValue &v = json["fileStoreReaders"]; v.isString())
+    {
+        this->fileStoreReaders = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreJournalLimit"]; v.isString())
+    {
+        this->fileStoreJournalLimit = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreReadBufferSize"]; v.isString())
+    {
+        this->fileStoreReadBufferSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreWriteBufferSize"]; v.isString())
+    {
+        this->fileStoreWriteBufferSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreDeduplicate"]; v.isString())
+    {
+        this->fileStoreDeduplicate = (v.toString() == "true");
+    }
+    if (const QJsonValue &v = json["fileStoreCompression"]; v.isString())
+    {
+        this->fileStoreCompression = v.toString();
+    }
+    if (const QJsonValue &v = json["fileStoreCacheSize"]; v.isString())
+    {
+        this->fileStoreCacheSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreCacheMaxFileSize"]; v.isString())
+    {
+        this->fileStoreCacheMaxFileSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreShardLevels"]; v.isString())
+    {
+        this->fileStoreShardLevels = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreDurability"]; v.isString())
+    {
+        this->fileStoreDurability = v.toString();
+    }
+    if (const QJsonValue &v = json["fileStoreGroupCommitWindow"]; v.isString())
+    {
+        this->fileStoreGroupCommitWindow = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreJournalFlushInterval"]; v.isString())
+    {
+        this->fileStoreJournalFlushInterval = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreJournalFlushCount"]; v.isString())
+    {
+        this->fileStoreJournalFlushCount = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreArchiveMaxSize"]; v.isString())
+    {
+        this->fileStoreArchiveMaxSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreScrubBandwidth"]; v.isString())
+    {
+        this->fileStoreScrubBandwidth = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreScrubInterval"]; v.isString())
+    {
+        this->fileStoreScrubInterval = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreChecksum"]; v.isString())
+    {
+        this->fileStoreChecksum = v.toString();
+    }
+    if (const QJsonValue &v = json["fileStoreRetrieveMaxSize"]; v.isString())
+    {
+        this->fileStoreRetrieveMaxSize = v.toString().toLongLong();
+    }
+    if (const QJsonValue &v = json["fileStoreUploadSessionTimeout"]; v.isString())
+    {
+        this->fileStoreUploadSessionTimeout = v.toString().toUInt();
+    }
+    if (const QJsonValue &v = json["fileStoreArchiveMemoryLimit"]; v.isString())
+    {
+        this->fileStoreArchiveMemoryLimit = v.toString().toLongLong();
+    }
     if (const QJsonValue &v = json["maxReportLength"]; v.isString())
     {
         this->maxReportLength = v.toString().toLongLong();
@@ -400,6 +721,26 @@ QJsonObject Configuration::toJson() const
     json["fileStore"] = this->fileStore;
     json["fileStoreMaxSize"] = QString::number(this->fileStoreMaxSize);
     json["fileStoreMaxFileSize"] = QString::number(this->fileStoreMaxFileSize);
+    json["fileStoreReaders"] = QString::number(this->fileStoreReaders);
+    json["fileStoreJournalLimit"] = QString::number(this->fileStoreJournalLimit);
+    json["fileStoreReadBufferSize"] = QString::number(this->fileStoreReadBufferSize);
+    json["fileStoreWriteBufferSize"] = QString::number(this->fileStoreWriteBufferSize);
+    json["fileStoreDeduplicate"] = QString(this->fileStoreDeduplicate ? "true" : "false");
+    json["fileStoreCompression"] = this->fileStoreCompression;
+    json["fileStoreCacheSize"] = QString::number(this->fileStoreCacheSize);
+    json["fileStoreCacheMaxFileSize"] = QString::number(this->fileStoreCacheMaxFileSize);
+    json["fileStoreShardLevels"] = QString::number(this->fileStoreShardLevels);
+    json["fileStoreDurability"] = this->fileStoreDurability;
+    json["fileStoreGroupCommitWindow"] = QString::number(this->fileStoreGroupCommitWindow);
+    json["fileStoreJournalFlushInterval"] = QString::number(this->fileStoreJournalFlushInterval);
+    json["fileStoreJournalFlushCount"] = QString::number(this->fileStoreJournalFlushCount);
+    json["fileStoreArchiveMaxSize"] = QString::number(this->fileStoreArchiveMaxSize);
+    json["fileStoreScrubBandwidth"] = QString::number(this->fileStoreScrubBandwidth);
+    json["fileStoreScrubInterval"] = QString::number(this->fileStoreScrubInterval);
+    json["fileStoreChecksum"] = this->fileStoreChecksum;
+    json["fileStoreRetrieveMaxSize"] = QString::number(this->fileStoreRetrieveMaxSize);
+    json["fileStoreUploadSessionTimeout"] = QString::number(this->fileStoreUploadSessionTimeout);
+    json["fileStoreArchiveMemoryLimit"] = QString::number(this->fileStoreArchiveMemoryLimit);
     json["maxReportLength"] = QString::number(this->maxReportLength);
     json["maxCommentLength"] = QString::number(this->maxCommentLength);
     json["senderEmailAddress"] = this->senderEmailAddress;
@@ -550,6 +891,106 @@ qint64 Configuration::getDefaultFileStoreMaxFileSize()
     return -1;
 }
 
+uint Configuration::getDefaultFileStoreReaders()
+{
+    return 0;
+}
+
+qint64 Configuration::getDefaultFileStoreJournalLimit()
+{
+    return 10000;
+}
+
+qint64 Configuration::getDefaultFileStoreReadBufferSize()
+{
+    return 1048576;
+}
+
+qint64 Configuration::getDefaultFileStoreWriteBufferSize()
+{
+    return 1048576;
+}
+
+bool Configuration::getDefaultFileStoreDeduplicate()
+{
+    return false;
+}
+
+QString Configuration::getDefaultFileStoreCompression()
+{
+    return QString();
+}
+
+qint64 Configuration::getDefaultFileStoreCacheSize()
+{
+    return 67108864;
+}
+
+qint64 Configuration::getDefaultFileStoreCacheMaxFileSize()
+{
+    return 1048576;
+}
+
+uint Configuration::getDefaultFileStoreShardLevels()
+{
+    return 0;
+}
+
+QString Configuration::getDefaultFileStoreDurability()
+{
+    return FileSync::Durability::None;
+}
+
+uint Configuration::getDefaultFileStoreGroupCommitWindow()
+{
+    return 10;
+}
+
+uint Configuration::getDefaultFileStoreJournalFlushInterval()
+{
+    return 100;
+}
+
+uint Configuration::getDefaultFileStoreJournalFlushCount()
+{
+    return 1000;
+}
+
+qint64 Configuration::getDefaultFileStoreArchiveMaxSize()
+{
+    return 33554432;
+}
+
+qint64 Configuration::getDefaultFileStoreScrubBandwidth()
+{
+    return 1048576;
+}
+
+uint Configuration::getDefaultFileStoreScrubInterval()
+{
+    return 86400;
+}
+
+QString Configuration::getDefaultFileStoreChecksum()
+{
+    return QString("xxh64");
+}
+
+qint64 Configuration::getDefaultFileStoreRetrieveMaxSize()
+{
+    return 0;
+}
+
+uint Configuration::getDefaultFileStoreUploadSessionTimeout()
+{
+    return 86400;
+}
+
+qint64 Configuration::getDefaultFileStoreArchiveMemoryLimit()
+{
+    return 268435456;
+}
+
 qint64 Configuration::getDefaultMaxReportLength()
 {
     return RReportRecord::defaultMaxReportLength;
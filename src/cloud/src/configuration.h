@@ -50,6 +50,26 @@ class Configuration
         QString fileStore;
         qint64 fileStoreMaxSize;
         qint64 fileStoreMaxFileSize;
+        uint fileStoreReaders;
+        qint64 fileStoreJournalLimit;
+        qint64 fileStoreReadBufferSize;
+        qint64 fileStoreWriteBufferSize;
+        bool fileStoreDeduplicate;
+        QString fileStoreCompression;
+        qint64 fileStoreCacheSize;
+        qint64 fileStoreCacheMaxFileSize;
+        uint fileStoreShardLevels;
+        QString fileStoreDurability;
+        uint fileStoreGroupCommitWindow;
+        uint fileStoreJournalFlushInterval;
+        uint fileStoreJournalFlushCount;
+        qint64 fileStoreArchiveMaxSize;
+        qint64 fileStoreScrubBandwidth;
+        uint fileStoreScrubInterval;
+        QString fileStoreChecksum;
+        qint64 fileStoreRetrieveMaxSize;
+        uint fileStoreUploadSessionTimeout;
+        qint64 fileStoreArchiveMemoryLimit;
 
         qint64 maxReportLength;
         qint64 maxCommentLength;
@@ -106,6 +126,66 @@ class Configuration
         qint64 getFileStoreMaxFileSize() const;
         void setFileStoreMaxFileSize(qint64 fileStoreMaxFileSize);
 
+        uint getFileStoreReaders() const;
+        void setFileStoreReaders(uint fileStoreReaders);
+
+        qint64 getFileStoreJournalLimit() const;
+        void setFileStoreJournalLimit(qint64 fileStoreJournalLimit);
+
+        qint64 getFileStoreReadBufferSize() const;
+        void setFileStoreReadBufferSize(qint64 fileStoreReadBufferSize);
+
+        qint64 getFileStoreWriteBufferSize() const;
+        void setFileStoreWriteBufferSize(qint64 fileStoreWriteBufferSize);
+
+        bool getFileStoreDeduplicate() const;
+        void setFileStoreDeduplicate(bool fileStoreDeduplicate);
+
+        const QString &getFileStoreCompression() const;
+        void setFileStoreCompression(const QString &fileStoreCompression);
+
+        qint64 getFileStoreCacheSize() const;
+        void setFileStoreCacheSize(qint64 fileStoreCacheSize);
+
+        qint64 getFileStoreCacheMaxFileSize() const;
+        void setFileStoreCacheMaxFileSize(qint64 fileStoreCacheMaxFileSize);
+
+        uint getFileStoreShardLevels() const;
+        void setFileStoreShardLevels(uint fileStoreShardLevels);
+
+        const QString &getFileStoreDurability() const;
+        void setFileStoreDurability(const QString &fileStoreDurability);
+
+        uint getFileStoreGroupCommitWindow() const;
+        void setFileStoreGroupCommitWindow(uint fileStoreGroupCommitWindow);
+
+        uint getFileStoreJournalFlushInterval() const;
+        void setFileStoreJournalFlushInterval(uint fileStoreJournalFlushInterval);
+
+        uint getFileStoreJournalFlushCount() const;
+        void setFileStoreJournalFlushCount(uint fileStoreJournalFlushCount);
+
+        qint64 getFileStoreArchiveMaxSize() const;
+        void setFileStoreArchiveMaxSize(qint64 fileStoreArchiveMaxSize);
+
+        qint64 getFileStoreScrubBandwidth() const;
+        void setFileStoreScrubBandwidth(qint64 fileStoreScrubBandwidth);
+
+        uint getFileStoreScrubInterval() const;
+        void setFileStoreScrubInterval(uint fileStoreScrubInterval);
+
+        const QString &getFileStoreChecksum() const;
+        void setFileStoreChecksum(const QString &fileStoreChecksum);
+
+        qint64 getFileStoreRetrieveMaxSize() const;
+        void setFileStoreRetrieveMaxSize(qint64 fileStoreRetrieveMaxSize);
+
+        uint getFileStoreUploadSessionTimeout() const;
+        void setFileStoreUploadSessionTimeout(uint fileStoreUploadSessionTimeout);
+
+        qint64 getFileStoreArchiveMemoryLimit() const;
+        void setFileStoreArchiveMemoryLimit(qint64 fileStoreArchiveMemoryLimit);
+
         qint64 getMaxReportLength() const;
         void setMaxReportLength(qint64 maxReportLength);
 
@@ -230,6 +310,66 @@ class Configuration
         //! Get default maximum file size in file store.
         static qint64 getDefaultFileStoreMaxFileSize();
 
+        //! Get default number of file store reader threads (0 = ideal thread count).
+        static uint getDefaultFileStoreReaders();
+
+        //! Get default number of file store index journal records triggering index compaction.
+        static qint64 getDefaultFileStoreJournalLimit();
+
+        //! Get default size of buffer used to read files from file store.
+        static qint64 getDefaultFileStoreReadBufferSize();
+
+        //! Get default size of chunks written to file store.
+        static qint64 getDefaultFileStoreWriteBufferSize();
+
+        //! Get default flag whether file store keeps single copy of identical file contents.
+        static bool getDefaultFileStoreDeduplicate();
+
+        //! Get default codec used to compress stored files (empty = no compression).
+        static QString getDefaultFileStoreCompression();
+
+        //! Get default size of in-memory cache of file contents (0 = no cache).
+        static qint64 getDefaultFileStoreCacheSize();
+
+        //! Get default maximum size of file kept in in-memory cache.
+        static qint64 getDefaultFileStoreCacheMaxFileSize();
+
+        //! Get default number of directory levels file store is sharded into.
+        static uint getDefaultFileStoreShardLevels();
+
+        //! Get default durability of file store modifications (none, operation or group).
+        static QString getDefaultFileStoreDurability();
+
+        //! Get default time window (in milliseconds) of file store modifications synced to disk together.
+        static uint getDefaultFileStoreGroupCommitWindow();
+
+        //! Get default maximum time (in milliseconds) index modifications are kept before they are written to journal.
+        static uint getDefaultFileStoreJournalFlushInterval();
+
+        //! Get default maximum number of modifications kept before they are written to journal.
+        static uint getDefaultFileStoreJournalFlushCount();
+
+        //! Get default maximum size of archive assembled for multi-file download.
+        static qint64 getDefaultFileStoreArchiveMaxSize();
+
+        //! Get default bandwidth (bytes per second) of background integrity scrubbing (0 = disabled).
+        static qint64 getDefaultFileStoreScrubBandwidth();
+
+        //! Get default interval in seconds between background integrity scrubbing passes.
+        static uint getDefaultFileStoreScrubInterval();
+
+        //! Get default algorithm of checksum computed for stored files (md5, xxh64).
+        static QString getDefaultFileStoreChecksum();
+
+        //! Get default maximum size of content read by single file download.
+        static qint64 getDefaultFileStoreRetrieveMaxSize();
+
+        //! Get default time in seconds after which idle upload session expires (0 = never).
+        static uint getDefaultFileStoreUploadSessionTimeout();
+
+        //! Get default total size of archives assembled for multi-file downloads at the same time.
+        static qint64 getDefaultFileStoreArchiveMemoryLimit();
+
         //! Get maximum report length.
         static qint64 getDefaultMaxReportLength();
 
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include <QStringList>
+
+#include <rbl_error.h>
+
+#include "file_archive.h"
+
+const qint64 FileArchive::blockSize = 512;
+
+qint64 FileArchive::findEntrySize(qint64 size)
+{
+    return FileArchive::blockSize + (size + FileArchive::blockSize - 1) / FileArchive::blockSize * FileArchive::blockSize;
+}
+
+qint64 FileArchive::findEndSize()
+{
+    return 2 * FileArchive::blockSize;
+}
+
+QString FileArchive::findEntryName(const QString &path)
+{
+    const QStringList components = path.split('/',Qt::SkipEmptyParts);
+    if (components.isEmpty() || components.contains(".") || components.contains(".."))
+    {
+        return QString();
+    }
+    return components.join('/');
+}
+
+bool FileArchive::writeHeader(const QString &name, qint64 size, qint64 modified, char *block)
+{
+    Header *header = reinterpret_cast<Header*>(block);
+    memset(header,0,sizeof(Header));
+
+    // Long names are split at directory separator into prefix and name.
+    QByteArray nameBytes = name.toUtf8();
+    if (nameBytes.isEmpty())
+    {
+        return false;
+    }
+    if (nameBytes.size() <= qsizetype(sizeof(Header::name)))
+    {
+        memcpy(header->name,nameBytes.constData(),nameBytes.size());
+    }
+    else
+    {
+        qsizetype separator = nameBytes.lastIndexOf('/',qsizetype(sizeof(Header::prefix)));
+        if (separator <= 0 || nameBytes.size() - separator - 1 > qsizetype(sizeof(Header::name)) || separator == nameBytes.size() - 1)
+        {
+            return false;
+        }
+        memcpy(header->prefix,nameBytes.constData(),separator);
+        memcpy(header->name,nameBytes.constData() + separator + 1,nameBytes.size() - separator - 1);
+    }
+
+    FileArchive::writeOctal(header->mode,sizeof(Header::mode),0644);
+    FileArchive::writeOctal(header->uid,sizeof(Header::uid),0);
+    FileArchive::writeOctal(header->gid,sizeof(Header::gid),0);
+    if (quint64(size) < (quint64(1) << 33))
+    {
+        FileArchive::writeOctal(header->size,sizeof(Header::size),quint64(size));
+    }
+    else
+    {
+        header->size[0] = char(0x80);
+        for (qsizetype i=qsizetype(sizeof(Header::size))-1;i>0;i--)
+        {
+            header->size[i] = char(quint64(size) >> (8 * (sizeof(Header::size) - 1 - i)));
+        }
+    }
+    FileArchive::writeOctal(header->mtime,sizeof(Header::mtime),quint64(qMax(modified,qint64(0))));
+    header->typeflag = '0';
+    memcpy(header->magic,"ustar",6);
+    memcpy(header->version,"00",2);
+
+    // Checksum is computed with checksum field filled with spaces.
+    memset(header->checksum,' ',sizeof(Header::checksum));
+    quint32 checksum = 0;
+    for (qsizetype i=0;i<qsizetype(sizeof(Header));i++)
+    {
+        checksum += uchar(block[i]);
+    }
+    FileArchive::writeOctal(header->checksum,sizeof(Header::checksum) - 1,checksum);
+
+    return true;
+}
+
+void FileArchive::writeOctal(char *field, qsizetype fieldSize, quint64 value)
+{
+    char buffer[32];
+    snprintf(buffer,sizeof(buffer),"%0*llo",int(fieldSize - 1),static_cast<unsigned long long>(value));
+    memcpy(field,buffer,fieldSize);
+}
+
+QList<FileArchive::Entry> FileArchive::readEntries(QByteArrayView archive)
+{
+    QList<Entry> entries;
+    QString longName;
+    qint64 position = 0;
+
+    // Archive ends with zero block, trailing data after it is ignored.
+    while (true)
+    {
+        if (archive.size() - position < FileArchive::blockSize)
+        {
+            throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                         "Archive is truncated at offset %lld.",
+                         qlonglong(position));
+        }
+        const char *block = archive.data() + position;
+        if (std::all_of(block,block + FileArchive::blockSize,[](char c) { return c == 0; }))
+        {
+            break;
+        }
+        if (!FileArchive::isChecksumValid(block))
+        {
+            throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                         "Archive header at offset %lld is corrupted.",
+                         qlonglong(position));
+        }
+
+        const Header *header = reinterpret_cast<const Header*>(block);
+        qint64 size = FileArchive::readNumber(header->size,sizeof(Header::size));
+        if (size < 0 || size > archive.size() - position - FileArchive::blockSize)
+        {
+            throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                         "Archive entry at offset %lld is truncated.",
+                         qlonglong(position));
+        }
+        QByteArrayView content(block + FileArchive::blockSize,size);
+
+        if (header->typeflag == 'L')
+        {
+            longName = FileArchive::readString(content.data(),content.size());
+        }
+        else if (header->typeflag == 'x')
+        {
+            longName = FileArchive::readPaxPath(content);
+        }
+        else
+        {
+            if (header->typeflag == '0' || header->typeflag == '\0' || header->typeflag == '7')
+            {
+                Entry entry;
+                if (!longName.isEmpty())
+                {
+                    entry.name = longName;
+                }
+                else
+                {
+                    QString prefix = FileArchive::readString(header->prefix,sizeof(Header::prefix));
+                    QString name = FileArchive::readString(header->name,sizeof(Header::name));
+                    entry.name = prefix.isEmpty() ? name : prefix + '/' + name;
+                }
+                entry.offset = position + FileArchive::blockSize;
+                entry.size = size;
+                entries.append(entry);
+            }
+            longName.clear();
+        }
+
+        position += FileArchive::findEntrySize(size);
+    }
+
+    return entries;
+}
+
+qint64 FileArchive::readNumber(const char *field, qsizetype fieldSize)
+{
+    // Base-256 number is marked by highest bit of first byte.
+    if (uchar(field[0]) & 0x80)
+    {
+        if (uchar(field[0]) != 0x80)
+        {
+            return -1;
+        }
+        quint64 value = 0;
+        for (qsizetype i=1;i<fieldSize;i++)
+        {
+            if (value >> 55)
+            {
+                return -1;
+            }
+            value = (value << 8) | uchar(field[i]);
+        }
+        return (value >> 63) ? -1 : qint64(value);
+    }
+
+    qsizetype i = 0;
+    while (i < fieldSize && field[i] == ' ')
+    {
+        i++;
+    }
+    quint64 value = 0;
+    for (;i<fieldSize && field[i] != '\0' && field[i] != ' ';i++)
+    {
+        if (field[i] < '0' || field[i] > '7')
+        {
+            return -1;
+        }
+        value = (value << 3) | quint64(field[i] - '0');
+    }
+    return qint64(value);
+}
+
+QString FileArchive::readString(const char *field, qsizetype fieldSize)
+{
+    return QString::fromUtf8(field,qsizetype(strnlen(field,size_t(fieldSize))));
+}
+
+QString FileArchive::readPaxPath(QByteArrayView records)
+{
+    // Each record has form "<length> <key>=<value>\n" where length includes the whole record.
+    QString path;
+    qsizetype position = 0;
+    while (position < records.size())
+    {
+        qsizetype space = records.indexOf(' ',position);
+        if (space < 0)
+        {
+            break;
+        }
+        bool ok = false;
+        qsizetype length = records.sliced(position,space - position).toLongLong(&ok);
+        if (!ok || length <= space - position || length > records.size() - position)
+        {
+            break;
+        }
+        QByteArrayView record = records.sliced(space + 1,length - (space - position) - 1);
+        if (record.endsWith('\n'))
+        {
+            record.chop(1);
+        }
+        if (record.startsWith("path="))
+        {
+            path = QString::fromUtf8(record.sliced(5));
+        }
+        position += length;
+    }
+    return path;
+}
+
+bool FileArchive::isChecksumValid(const char *block)
+{
+    const Header *header = reinterpret_cast<const Header*>(block);
+    qint64 checksum = FileArchive::readNumber(header->checksum,sizeof(Header::checksum));
+
+    // Checksum is computed with checksum field filled with spaces.
+    quint32 sum = 0;
+    for (qsizetype i=0;i<qsizetype(sizeof(Header));i++)
+    {
+        bool inChecksum = (i >= qsizetype(offsetof(Header,checksum)) && i < qsizetype(offsetof(Header,checksum) + sizeof(Header::checksum)));
+        sum += inChecksum ? uchar(' ') : uchar(block[i]);
+    }
+    return checksum == qint64(sum);
+}
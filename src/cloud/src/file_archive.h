@@ -0,0 +1,97 @@
+#ifndef FILE_ARCHIVE_H
+#define FILE_ARCHIVE_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+//! Tar (ustar) archive format.
+//!
+//! Archive is a sequence of entries followed by two zero blocks:
+//!   Header | content padded to block size
+//! Sizes which do not fit octal size field are stored in base-256 (GNU extension).
+//! Long names are read from GNU long name and pax path records.
+class FileArchive
+{
+
+    public:
+
+        //! Regular file entry of archive.
+        struct Entry
+        {
+            //! Entry name.
+            QString name;
+            //! Offset of content in archive.
+            qint64 offset = 0;
+            //! Size of content.
+            qint64 size = 0;
+        };
+
+        //! Size of archive block.
+        static const qint64 blockSize;
+
+    protected:
+
+        struct Header
+        {
+            char name[100];
+            char mode[8];
+            char uid[8];
+            char gid[8];
+            char size[12];
+            char mtime[12];
+            char checksum[8];
+            char typeflag;
+            char linkname[100];
+            char magic[6];
+            char version[2];
+            char uname[32];
+            char gname[32];
+            char devmajor[8];
+            char devminor[8];
+            char prefix[155];
+            char padding[12];
+        };
+
+        static_assert(sizeof(Header) == 512, "Unexpected archive header size");
+
+    public:
+
+        //! Return size of archive entry holding content of given size.
+        static qint64 findEntrySize(qint64 size);
+
+        //! Return size of end-of-archive marker.
+        static qint64 findEndSize();
+
+        //! Return entry name for given file path or empty string if path cannot be safely stored.
+        //! Leading slashes are removed, paths with "." or ".." components are rejected.
+        static QString findEntryName(const QString &path);
+
+        //! Write header of regular file entry into given block.
+        //! Return false if name does not fit the header.
+        static bool writeHeader(const QString &name, qint64 size, qint64 modified, char *block);
+
+        //! Read regular file entries of archive, other entries (directories, links, ...) are skipped.
+        //! Throws RError if archive is malformed or truncated.
+        static QList<Entry> readEntries(QByteArrayView archive);
+
+    protected:
+
+        //! Write number as zero terminated octal string into field of given size.
+        static void writeOctal(char *field, qsizetype fieldSize, quint64 value);
+
+        //! Read octal or base-256 number from field of given size (-1 if field is not valid number).
+        static qint64 readNumber(const char *field, qsizetype fieldSize);
+
+        //! Read zero terminated string from field of given size.
+        static QString readString(const char *field, qsizetype fieldSize);
+
+        //! Read path from pax extended header records (empty if records contain no path).
+        static QString readPaxPath(QByteArrayView records);
+
+        //! Check if header checksum matches its content.
+        static bool isChecksumValid(const char *block);
+
+};
+
+#endif // FILE_ARCHIVE_H
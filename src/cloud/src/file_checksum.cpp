@@ -0,0 +1,169 @@
+#include <bit>
+#include <cstring>
+
+#include <QtEndian>
+
+#include "file_checksum.h"
+
+const QString FileChecksum::md5 = "md5";
+const QString FileChecksum::xxh64 = "xxh64";
+
+static const quint64 xxh64Prime1 = 0x9E3779B185EBCA87ULL;
+static const quint64 xxh64Prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const quint64 xxh64Prime3 = 0x165667B19E3779F9ULL;
+static const quint64 xxh64Prime4 = 0x85EBCA77C2B2AE63ULL;
+static const quint64 xxh64Prime5 = 0x27D4EB2F165667C5ULL;
+
+FileChecksum::FileChecksum(const QString &algorithm)
+    : algorithm{algorithm}
+    , md5Hash{QCryptographicHash::Md5}
+    , accumulators{xxh64Prime1 + xxh64Prime2,xxh64Prime2,0,0 - xxh64Prime1}
+    , stripe{}
+    , stripeSize{0}
+    , totalSize{0}
+{
+
+}
+
+const QString &FileChecksum::getAlgorithm() const
+{
+    return this->algorithm;
+}
+
+void FileChecksum::addData(QByteArrayView data)
+{
+    if (this->algorithm == FileChecksum::md5)
+    {
+        this->md5Hash.addData(data);
+        return;
+    }
+
+    const uchar *input = reinterpret_cast<const uchar*>(data.data());
+    qsizetype size = data.size();
+    this->totalSize += quint64(size);
+
+    // Stripe left over from previous data is completed first.
+    if (this->stripeSize > 0)
+    {
+        qsizetype nBytes = qMin(size,qsizetype(sizeof(this->stripe)) - this->stripeSize);
+        memcpy(this->stripe + this->stripeSize,input,nBytes);
+        this->stripeSize += nBytes;
+        input += nBytes;
+        size -= nBytes;
+        if (this->stripeSize < qsizetype(sizeof(this->stripe)))
+        {
+            return;
+        }
+        this->consumeStripe(this->stripe);
+        this->stripeSize = 0;
+    }
+
+    while (size >= qsizetype(sizeof(this->stripe)))
+    {
+        this->consumeStripe(input);
+        input += sizeof(this->stripe);
+        size -= qsizetype(sizeof(this->stripe));
+    }
+
+    memcpy(this->stripe,input,size);
+    this->stripeSize = size;
+}
+
+QString FileChecksum::result() const
+{
+    if (this->algorithm == FileChecksum::md5)
+    {
+        return QString(this->md5Hash.result().toHex());
+    }
+
+    quint64 hash = 0;
+    if (this->totalSize >= sizeof(this->stripe))
+    {
+        hash = std::rotl(this->accumulators[0],1) + std::rotl(this->accumulators[1],7)
+             + std::rotl(this->accumulators[2],12) + std::rotl(this->accumulators[3],18);
+        for (quint64 accumulator : this->accumulators)
+        {
+            hash = FileChecksum::mergeRound(hash,accumulator);
+        }
+    }
+    else
+    {
+        hash = xxh64Prime5;
+    }
+    hash += this->totalSize;
+
+    // Remaining bytes of incomplete stripe.
+    const uchar *input = this->stripe;
+    qsizetype size = this->stripeSize;
+    for (;size >= 8;input += 8,size -= 8)
+    {
+        hash ^= FileChecksum::round(0,qFromLittleEndian<quint64>(input));
+        hash = std::rotl(hash,27) * xxh64Prime1 + xxh64Prime4;
+    }
+    if (size >= 4)
+    {
+        hash ^= quint64(qFromLittleEndian<quint32>(input)) * xxh64Prime1;
+        hash = std::rotl(hash,23) * xxh64Prime2 + xxh64Prime3;
+        input += 4;
+        size -= 4;
+    }
+    for (;size > 0;input++,size--)
+    {
+        hash ^= quint64(*input) * xxh64Prime5;
+        hash = std::rotl(hash,11) * xxh64Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= xxh64Prime2;
+    hash ^= hash >> 29;
+    hash *= xxh64Prime3;
+    hash ^= hash >> 32;
+
+    return QString("%1").arg(hash,16,16,QChar('0'));
+}
+
+bool FileChecksum::isSupported(const QString &algorithm)
+{
+    return algorithm == FileChecksum::md5 || algorithm == FileChecksum::xxh64;
+}
+
+QString FileChecksum::toContentChecksum(const QString &algorithm, const QString &checksum)
+{
+    return (algorithm == FileChecksum::md5) ? checksum : algorithm + ":" + checksum;
+}
+
+QString FileChecksum::findContentChecksum(const RFileInfo &fileInfo, const FileStorage &fileStorage)
+{
+    if (fileStorage.checksum.isEmpty())
+    {
+        return fileInfo.getMd5Checksum();
+    }
+    return FileChecksum::toContentChecksum(fileStorage.checksumAlgorithm,fileStorage.checksum);
+}
+
+QString FileChecksum::findAlgorithm(const QString &contentChecksum)
+{
+    qsizetype separator = contentChecksum.indexOf(':');
+    return (separator < 0) ? FileChecksum::md5 : contentChecksum.first(separator);
+}
+
+void FileChecksum::consumeStripe(const uchar *data)
+{
+    for (qsizetype i=0;i<4;i++)
+    {
+        this->accumulators[i] = FileChecksum::round(this->accumulators[i],qFromLittleEndian<quint64>(data + 8 * i));
+    }
+}
+
+quint64 FileChecksum::round(quint64 accumulator, quint64 input)
+{
+    accumulator += input * xxh64Prime2;
+    accumulator = std::rotl(accumulator,31);
+    return accumulator * xxh64Prime1;
+}
+
+quint64 FileChecksum::mergeRound(quint64 accumulator, quint64 value)
+{
+    accumulator ^= FileChecksum::round(0,value);
+    return accumulator * xxh64Prime1 + xxh64Prime4;
+}
@@ -0,0 +1,82 @@
+#ifndef FILE_CHECKSUM_H
+#define FILE_CHECKSUM_H
+
+#include <QByteArrayView>
+#include <QCryptographicHash>
+#include <QString>
+
+#include <rcl_file_info.h>
+
+#include "file_codec.h"
+
+//! Checksums of file content.
+//!
+//! MD5 is the checksum of file information (API compatibility, content addressed store).
+//! XXH64 is a fast non-cryptographic checksum used to verify content integrity, with it
+//! MD5 is computed only once a client asks for it.
+class FileChecksum
+{
+
+    public:
+
+        //! MD5 checksum.
+        static const QString md5;
+        //! XXH64 checksum.
+        static const QString xxh64;
+
+    protected:
+
+        //! Checksum algorithm.
+        QString algorithm;
+        //! MD5 hash (used only by MD5 algorithm).
+        QCryptographicHash md5Hash;
+        //! XXH64 accumulators.
+        quint64 accumulators[4];
+        //! XXH64 stripe not yet consumed.
+        uchar stripe[32];
+        //! Number of bytes in stripe.
+        qsizetype stripeSize;
+        //! Number of hashed bytes.
+        quint64 totalSize;
+
+    public:
+
+        //! Constructor.
+        explicit FileChecksum(const QString &algorithm);
+
+        //! Get checksum algorithm.
+        const QString &getAlgorithm() const;
+
+        //! Add data to checksum.
+        void addData(QByteArrayView data);
+
+        //! Return hexadecimal checksum of added data.
+        QString result() const;
+
+        //! Check if algorithm is supported.
+        static bool isSupported(const QString &algorithm);
+
+        //! Return content checksum identifying given checksum of given algorithm.
+        //! MD5 checksum is used as is, other checksums are prefixed by algorithm ("xxh64:<checksum>").
+        static QString toContentChecksum(const QString &algorithm, const QString &checksum);
+
+        //! Return content checksum of object with given file information and stored form.
+        static QString findContentChecksum(const RFileInfo &fileInfo, const FileStorage &fileStorage);
+
+        //! Return algorithm of given content checksum.
+        static QString findAlgorithm(const QString &contentChecksum);
+
+    protected:
+
+        //! Consume single 32 byte stripe.
+        void consumeStripe(const uchar *data);
+
+        //! XXH64 accumulator round.
+        static quint64 round(quint64 accumulator, quint64 input);
+
+        //! XXH64 accumulator merge round.
+        static quint64 mergeRound(quint64 accumulator, quint64 value);
+
+};
+
+#endif // FILE_CHECKSUM_H
@@ -0,0 +1,141 @@
+#include <cstring>
+
+#include "file_codec.h"
+
+const QString FileCodec::zlib = "zlib";
+
+const int FileCodec::compressionLevel = 1;
+
+const int FileCodec::minSaving = 10;
+
+bool FileCodec::isSupported(const QString &codec)
+{
+    return codec.isEmpty() || codec == FileCodec::zlib;
+}
+
+QByteArray FileCodec::encodeFrame(QByteArrayView data)
+{
+    QByteArray compressed = qCompress(reinterpret_cast<const uchar*>(data.data()),data.size(),FileCodec::compressionLevel);
+    // Data which does not compress well (e.g. already compressed parts) is stored raw.
+    bool raw = !FileCodec::isWorthCompressing(data.size(),compressed.size());
+    QByteArrayView storedData = raw ? data : QByteArrayView(compressed);
+
+    FrameHeader header{};
+    header.storedSize = quint32(storedData.size()) | (raw ? FileCodec::rawFrameFlag : 0);
+    header.size = quint32(data.size());
+
+    QByteArray frame;
+    frame.reserve(qsizetype(sizeof(FrameHeader)) + storedData.size());
+    frame.append(reinterpret_cast<const char*>(&header),sizeof(FrameHeader));
+    frame.append(storedData);
+    return frame;
+}
+
+bool FileCodec::decode(QIODevice &device, qint64 offset, qint64 length, char *output)
+{
+    qint64 position = 0;
+    qint64 nWritten = 0;
+
+    while (nWritten < length)
+    {
+        qint64 frameSize = 0;
+        qint64 storedSize = 0;
+        bool raw = false;
+        if (!FileCodec::readFrameHeader(device,frameSize,storedSize,raw))
+        {
+            return false;
+        }
+
+        // Frames preceding requested range are skipped without decompressing.
+        if (position + frameSize <= offset)
+        {
+            if (device.skip(storedSize) != storedSize)
+            {
+                return false;
+            }
+            position += frameSize;
+            continue;
+        }
+
+        qint64 from = qMax(offset - position,qint64(0));
+        qint64 nBytes = qMin(frameSize - from,length - nWritten);
+
+        if (raw)
+        {
+            // Raw frame is read directly into output.
+            if (device.skip(from) != from ||
+                device.read(output + nWritten,nBytes) != nBytes ||
+                device.skip(storedSize - from - nBytes) != storedSize - from - nBytes)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            QByteArray frame = device.read(storedSize);
+            if (frame.size() != storedSize)
+            {
+                return false;
+            }
+            QByteArray data = qUncompress(frame);
+            if (data.size() != frameSize)
+            {
+                return false;
+            }
+            memcpy(output + nWritten,data.constData() + from,size_t(nBytes));
+        }
+
+        nWritten += nBytes;
+        position += frameSize;
+    }
+
+    return true;
+}
+
+bool FileCodec::decodeFrames(QIODevice &device, const std::function<bool(QByteArrayView)> &frameFunction)
+{
+    while (!device.atEnd())
+    {
+        qint64 frameSize = 0;
+        qint64 storedSize = 0;
+        bool raw = false;
+        if (!FileCodec::readFrameHeader(device,frameSize,storedSize,raw))
+        {
+            return false;
+        }
+
+        QByteArray frame = device.read(storedSize);
+        if (frame.size() != storedSize)
+        {
+            return false;
+        }
+        QByteArray data = raw ? frame : qUncompress(frame);
+        if (data.size() != frameSize || !frameFunction(data))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FileCodec::isWorthCompressing(qint64 size, qint64 compressedSize)
+{
+    return compressedSize * 100 <= size * (100 - FileCodec::minSaving);
+}
+
+bool FileCodec::readFrameHeader(QIODevice &device, qint64 &frameSize, qint64 &storedSize, bool &raw)
+{
+    FrameHeader header{};
+    if (device.read(reinterpret_cast<char*>(&header),sizeof(FrameHeader)) != sizeof(FrameHeader))
+    {
+        return false;
+    }
+
+    raw = (header.storedSize & FileCodec::rawFrameFlag) != 0;
+    storedSize = header.storedSize & ~FileCodec::rawFrameFlag;
+    frameSize = header.size;
+
+    // Raw frame stores data as is.
+    return !raw || storedSize == frameSize;
+}
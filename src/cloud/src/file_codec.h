@@ -0,0 +1,88 @@
+#ifndef FILE_CODEC_H
+#define FILE_CODEC_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QtEndian>
+
+#include <functional>
+
+//! Stored form of file content.
+struct FileStorage
+{
+    //! Codec (empty if content is stored raw).
+    QString codec;
+    //! Size of stored content.
+    qint64 size = 0;
+    //! Algorithm of content checksum (empty if content is verified by MD5 checksum of file information).
+    QString checksumAlgorithm;
+    //! Content checksum.
+    QString checksum;
+};
+
+//! Codecs used to store file content.
+//!
+//! Encoded content is a sequence of independent frames:
+//!   FrameHeader | compressed or raw data
+//! so that any range can be decoded without decompressing preceding frames.
+//! Compression is decided per frame, frames which do not compress well are stored raw.
+class FileCodec
+{
+
+    public:
+
+        //! Zlib codec.
+        static const QString zlib;
+
+        //! Compression level (fast).
+        static const int compressionLevel;
+
+        //! Minimum space saving (in percent) for frame to be stored compressed.
+        static const int minSaving;
+
+    protected:
+
+        struct FrameHeader
+        {
+            //! Size of stored data (highest bit is set if data is stored raw).
+            quint32_le storedSize;
+            //! Size of decompressed data.
+            quint32_le size;
+        };
+
+        static_assert(sizeof(FrameHeader) == 8, "Unexpected frame header size");
+
+        //! Stored size flag of frame stored raw.
+        static const quint32 rawFrameFlag = 0x80000000;
+
+    public:
+
+        //! Check if codec is supported (empty codec = raw content).
+        static bool isSupported(const QString &codec);
+
+        //! Encode data into single frame (compressed only if it saves enough space).
+        static QByteArray encodeFrame(QByteArrayView data);
+
+        //! Decode range of content from device positioned at the beginning of stored content.
+        //! Output must have space for length bytes.
+        //! Return false if stored content cannot be read or is corrupted.
+        static bool decode(QIODevice &device, qint64 offset, qint64 length, char *output);
+
+        //! Decode whole content from device positioned at the beginning of stored content
+        //! and pass decoded frames to given function one at a time.
+        //! Return false if stored content cannot be read, is corrupted or function returns false.
+        static bool decodeFrames(QIODevice &device, const std::function<bool(QByteArrayView)> &frameFunction);
+
+    protected:
+
+        //! Check if compressed data saves enough space compared to raw data of given size.
+        static bool isWorthCompressing(qint64 size, qint64 compressedSize);
+
+        //! Read frame header and return size of decoded and stored data.
+        //! Return false if header cannot be read.
+        static bool readFrameHeader(QIODevice &device, qint64 &frameSize, qint64 &storedSize, bool &raw);
+
+};
+
+#endif // FILE_CODEC_H
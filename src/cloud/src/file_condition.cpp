@@ -0,0 +1,139 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <rbl_error.h>
+
+#include "file_condition.h"
+
+const RError::Type FileCondition::notModifiedErrorType = RError::NotFound;
+
+void FileCondition::_init(const FileCondition *pFileCondition)
+{
+    if (pFileCondition)
+    {
+        this->ifNoneMatch = pFileCondition->ifNoneMatch;
+        this->ifModifiedSince = pFileCondition->ifModifiedSince;
+    }
+}
+
+FileCondition::FileCondition()
+    : ifModifiedSince(-1)
+{
+    this->_init();
+}
+
+FileCondition::FileCondition(const FileCondition &fileCondition)
+{
+    this->_init(&fileCondition);
+}
+
+FileCondition::~FileCondition()
+{
+
+}
+
+FileCondition &FileCondition::operator =(const FileCondition &fileCondition)
+{
+    this->_init(&fileCondition);
+    return (*this);
+}
+
+bool FileCondition::isEmpty() const
+{
+    return this->ifNoneMatch.isEmpty() && this->ifModifiedSince < 0;
+}
+
+bool FileCondition::isNotModified(const RFileInfo &fileInfo, const QString &contentChecksum) const
+{
+    if (!this->ifNoneMatch.isEmpty())
+    {
+        const QString entityTag = FileCondition::toEntityTag(contentChecksum);
+        for (const QString &tag : this->ifNoneMatch)
+        {
+            // Weak comparison as required for If-None-Match.
+            if (tag == "*" || (tag.startsWith("W/") ? tag.sliced(2) : tag) == entityTag)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (this->ifModifiedSince >= 0)
+    {
+        return fileInfo.getUpdateDateTime() <= this->ifModifiedSince;
+    }
+    return false;
+}
+
+FileCondition FileCondition::fromJson(const QJsonObject &json)
+{
+    FileCondition fileCondition;
+
+    // Entity tags are given either as a list or as a comma separated header value.
+    QJsonValue ifNoneMatchValue = json["ifNoneMatch"];
+    QStringList tags;
+    if (ifNoneMatchValue.isString())
+    {
+        tags = ifNoneMatchValue.toString().split(',',Qt::SkipEmptyParts);
+    }
+    else if (ifNoneMatchValue.isArray())
+    {
+        for (const QJsonValue &value : ifNoneMatchValue.toArray())
+        {
+            tags.append(value.toString());
+        }
+    }
+    else if (!ifNoneMatchValue.isUndefined())
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,"Invalid value of \"ifNoneMatch\".");
+    }
+    for (const QString &tag : std::as_const(tags))
+    {
+        QString trimmedTag = tag.trimmed();
+        if (trimmedTag != "*" && !(trimmedTag.sliced(trimmedTag.startsWith("W/") ? 2 : 0).startsWith('"') && trimmedTag.endsWith('"')))
+        {
+            throw RError(RError::Type::InvalidInput,R_ERROR_REF,"Invalid entity tag \"%s\".",trimmedTag.toUtf8().constData());
+        }
+        fileCondition.ifNoneMatch.append(trimmedTag);
+    }
+
+    // Seconds since epoch are accepted both as number and as string.
+    QJsonValue ifModifiedSinceValue = json["ifModifiedSince"];
+    if (ifModifiedSinceValue.isDouble())
+    {
+        fileCondition.ifModifiedSince = qint64(ifModifiedSinceValue.toDouble());
+    }
+    else if (ifModifiedSinceValue.isString())
+    {
+        bool isOk = false;
+        fileCondition.ifModifiedSince = ifModifiedSinceValue.toString().toLongLong(&isOk);
+        if (!isOk)
+        {
+            throw RError(RError::Type::InvalidInput,R_ERROR_REF,"Invalid value of \"ifModifiedSince\".");
+        }
+    }
+    else if (!ifModifiedSinceValue.isUndefined())
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,"Invalid value of \"ifModifiedSince\".");
+    }
+    if (fileCondition.ifModifiedSince < -1)
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,"Invalid value of \"ifModifiedSince\".");
+    }
+
+    return fileCondition;
+}
+
+QString FileCondition::toEntityTag(const QString &contentChecksum)
+{
+    return "\"" + contentChecksum + "\"";
+}
+
+QByteArray FileCondition::toNotModifiedResponse(const RFileInfo &fileInfo, const QString &contentChecksum)
+{
+    QJsonObject json;
+    json["notModified"] = true;
+    json["etag"] = FileCondition::toEntityTag(contentChecksum);
+    json["updated"] = QString::number(fileInfo.getUpdateDateTime());
+    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,67 @@
+#ifndef FILE_CONDITION_H
+#define FILE_CONDITION_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <rbl_error.h>
+#include <rcl_file_info.h>
+
+//! Conditional request in HTTP If-None-Match / If-Modified-Since semantics.
+//! Entity tag of a file is its quoted content checksum (see FileChecksum::findContentChecksum()).
+class FileCondition
+{
+
+    public:
+
+        //! Error type of response to request on file which was not modified (no modified content was found).
+        //! Distinguishes not-modified response from content of the file.
+        static const RError::Type notModifiedErrorType;
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const FileCondition *pFileCondition = nullptr);
+
+    protected:
+
+        //! Entity tags (If-None-Match, "*" matches any file).
+        QStringList ifNoneMatch;
+        //! Modification time in seconds since epoch (If-Modified-Since, -1 = not set).
+        qint64 ifModifiedSince;
+
+    public:
+
+        //! Constructor.
+        FileCondition();
+
+        //! Copy constructor.
+        FileCondition(const FileCondition &fileCondition);
+
+        //! Destructor.
+        ~FileCondition();
+
+        //! Assignment operator.
+        FileCondition &operator =(const FileCondition &fileCondition);
+
+        //! Check if condition is set.
+        bool isEmpty() const;
+
+        //! Check if given file with given content checksum was not modified.
+        //! If-Modified-Since is ignored when If-None-Match is set.
+        bool isNotModified(const RFileInfo &fileInfo, const QString &contentChecksum) const;
+
+        //! Create condition from Json ("ifNoneMatch" and "ifModifiedSince" values).
+        //! Throws RError if Json values are not valid.
+        static FileCondition fromJson(const QJsonObject &json);
+
+        //! Return entity tag of file with given content checksum.
+        static QString toEntityTag(const QString &contentChecksum);
+
+        //! Return response to request on file with given content checksum which was not modified.
+        static QByteArray toNotModifiedResponse(const RFileInfo &fileInfo, const QString &contentChecksum);
+
+};
+
+#endif // FILE_CONDITION_H
@@ -0,0 +1,71 @@
+#include "file_content_cache.h"
+
+FileContentCache::FileContentCache()
+    : cache(0)
+    , maxContentSize(0)
+{
+
+}
+
+FileContentCache::~FileContentCache()
+{
+
+}
+
+void FileContentCache::setLimits(qint64 size, qint64 maxContentSize)
+{
+    QMutexLocker locker(&this->mutex);
+    this->cache.setMaxCost(qMax(size,qint64(0)));
+    this->maxContentSize = qMin(maxContentSize,size);
+}
+
+bool FileContentCache::isCacheable(qint64 contentSize) const
+{
+    QMutexLocker locker(&this->mutex);
+    return contentSize <= this->maxContentSize && this->cache.maxCost() > 0;
+}
+
+bool FileContentCache::find(const QUuid &id, const QString &checksum, QByteArray &content) const
+{
+    QMutexLocker locker(&this->mutex);
+    // Non-const lookup moves found entry to the front of LRU list.
+    const QByteArray *cachedContent = const_cast<QCache<Key,QByteArray>&>(this->cache).object(qMakePair(id,checksum));
+    if (!cachedContent)
+    {
+        return false;
+    }
+    content = *cachedContent;
+    return true;
+}
+
+qsizetype FileContentCache::insert(const QUuid &id, const QString &checksum, const QByteArray &content)
+{
+    QMutexLocker locker(&this->mutex);
+    if (content.size() > this->maxContentSize)
+    {
+        return 0;
+    }
+
+    Key key(qMakePair(id,checksum));
+    qsizetype nEntries = this->cache.size() + (this->cache.contains(key) ? 0 : 1);
+    this->cache.insert(key,new QByteArray(content),content.size());
+    return nEntries - this->cache.size();
+}
+
+void FileContentCache::remove(const QUuid &id, const QString &checksum)
+{
+    QMutexLocker locker(&this->mutex);
+    this->cache.remove(qMakePair(id,checksum));
+}
+
+qsizetype FileContentCache::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->cache.size();
+}
+
+qint64 FileContentCache::bytes() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->cache.totalCost();
+}
@@ -0,0 +1,62 @@
+#ifndef FILE_CONTENT_CACHE_H
+#define FILE_CONTENT_CACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QUuid>
+
+//! Thread-safe, byte budgeted LRU cache of file contents.
+//! Entries are keyed by object ID and content checksum so that content read
+//! before the file was updated is never served for the new content.
+class FileContentCache
+{
+
+    Q_DISABLE_COPY(FileContentCache)
+
+    protected:
+
+        typedef QPair<QUuid,QString> Key;
+
+        //! Cached contents (cost is content size).
+        QCache<Key,QByteArray> cache;
+        //! Maximum size of single content.
+        qint64 maxContentSize;
+        //! Cache mutex.
+        mutable QMutex mutex;
+
+    public:
+
+        //! Constructor.
+        FileContentCache();
+
+        //! Destructor.
+        ~FileContentCache();
+
+        //! Set cache size in bytes and maximum size of single content.
+        void setLimits(qint64 size, qint64 maxContentSize);
+
+        //! Check if content of given size can be cached.
+        bool isCacheable(qint64 contentSize) const;
+
+        //! Find content and return true if found.
+        //! Returned content is shared with the cache.
+        bool find(const QUuid &id, const QString &checksum, QByteArray &content) const;
+
+        //! Insert content and return number of evicted entries.
+        qsizetype insert(const QUuid &id, const QString &checksum, const QByteArray &content);
+
+        //! Remove content.
+        void remove(const QUuid &id, const QString &checksum);
+
+        //! Return number of cached entries.
+        qsizetype size() const;
+
+        //! Return total size of cached contents.
+        qint64 bytes() const;
+
+};
+
+#endif // FILE_CONTENT_CACHE_H
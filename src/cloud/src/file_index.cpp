@@ -1,10 +1,16 @@
+#include <algorithm>
+
 #include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
 #include <QTextStream>
 
 #include <rbl_error.h>
 #include <rbl_logger.h>
 #include <rbl_statistics.h>
 
+#include "file_checksum.h"
+#include "file_condition.h"
 #include "file_index.h"
 
 void FileIndex::_init(const FileIndex *pFileIndex)
@@ -12,15 +18,40 @@ void FileIndex::_init(const FileIndex *pFileIndex)
     if (pFileIndex)
     {
         this->index = pFileIndex->index;
+        this->snapshot = pFileIndex->snapshot;
+        this->shadowed = pFileIndex->shadowed;
+        this->nObjects = pFileIndex->nObjects;
+        this->userUsage = pFileIndex->userUsage;
+        this->totalUsage = pFileIndex->totalUsage;
+        QMutexLocker lookupIndexesLocker(&pFileIndex->lookupIndexesMutex);
+        this->pathIndex = pFileIndex->pathIndex;
+        this->tagIndex = pFileIndex->tagIndex;
+        this->lookupIndexesBuilt = pFileIndex->lookupIndexesBuilt;
+        lookupIndexesLocker.unlock();
+        this->storage = pFileIndex->storage;
+        this->totalStoredSize = pFileIndex->totalStoredSize;
+        this->countReferences = pFileIndex->countReferences;
+        this->references = pFileIndex->references;
+        this->journalRecords = pFileIndex->journalRecords;
+        QMutexLocker jsonCacheLocker(&pFileIndex->jsonCacheMutex);
+        this->jsonCache = pFileIndex->jsonCache;
     }
 }
 
 FileIndex::FileIndex()
+    : nObjects(0)
+    , lookupIndexesBuilt(true)
+    , totalStoredSize(0)
+    , countReferences(false)
 {
     this->_init();
 }
 
 FileIndex::FileIndex(const FileIndex &fileIndex)
+    : nObjects(0)
+    , lookupIndexesBuilt(true)
+    , totalStoredSize(0)
+    , countReferences(false)
 {
     this->_init(&fileIndex);
 }
@@ -36,7 +67,52 @@ FileIndex &FileIndex::operator =(const FileIndex &fileIndex)
     return (*this);
 }
 
+void FileIndex::setCountReferences(bool countReferences)
+{
+    this->countReferences = countReferences;
+}
+
 void FileIndex::readFromFile(const QString &fileName)
+{
+    if (!QFile::exists(fileName))
+    {
+        return;
+    }
+
+    this->snapshot.reset(new FileIndexSnapshot(fileName));
+    this->index.clear();
+    this->shadowed.clear();
+    this->nObjects = this->snapshot->size();
+    this->userUsage = this->snapshot->readUsage();
+    this->totalUsage = Usage();
+    for (auto iter = this->userUsage.cbegin(); iter != this->userUsage.cend(); ++iter)
+    {
+        this->totalUsage.size += iter.value().size;
+        this->totalUsage.count += iter.value().count;
+    }
+    this->pathIndex.clear();
+    this->tagIndex.clear();
+    this->lookupIndexesBuilt = false;
+    this->storage.clear();
+    this->totalStoredSize = this->snapshot->getStoredSize();
+    this->references = this->snapshot->readReferences();
+    QMutexLocker jsonCacheLocker(&this->jsonCacheMutex);
+    this->jsonCache.clear();
+    jsonCacheLocker.unlock();
+
+    if (this->countReferences != this->snapshot->hasReferences())
+    {
+        // Snapshot was written with different reference counting, count references once.
+        this->totalStoredSize = 0;
+        this->references.clear();
+        for (qsizetype position=0;position<this->snapshot->size();position++)
+        {
+            this->addReferences(this->countReferences ? this->snapshot->getChecksum(position) : QString(),this->snapshot->getStorage(position),1);
+        }
+    }
+}
+
+void FileIndex::readFromTextFile(const QString &fileName)
 {
     QFile indexFile(fileName);
     if (!indexFile.exists())
@@ -56,8 +132,7 @@ void FileIndex::readFromFile(const QString &fileName)
 
     while(!in.atEnd())
     {
-        RFileInfo info = RFileInfo::fromString(in.readLine());
-        this->index.insert(info.getId(),info);
+        this->insertObject(RFileInfo::fromString(in.readLine()));
     }
 
     indexFile.close();
@@ -65,77 +140,319 @@ void FileIndex::readFromFile(const QString &fileName)
 
 void FileIndex::writeToFile(const QString &fileName) const
 {
-    QFile indexFile(fileName);
-    if(!indexFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    FileIndexSnapshot::write(fileName,this->nObjects,[this](const std::function<void(const RFileInfo &, const FileStorage &)> &writeObject)
     {
-        throw RError(RError::Type::OpenFile,R_ERROR_REF,
-                     "Failed to open index file \"%s\" for writing. %s.",
-                     indexFile.fileName().toUtf8().constData(),
-                     indexFile.errorString().toUtf8().constData());
+        this->forEachObject([&](const RFileInfo &fileInfo)
+        {
+            writeObject(fileInfo,this->getObjectStorage(fileInfo.getId()));
+            return true;
+        });
+    },this->userUsage,this->countReferences ? &this->references : nullptr,this->totalStoredSize);
+}
+
+QSharedPointer<const FileIndexSnapshot> FileIndex::getSnapshot() const
+{
+    return this->snapshot;
+}
+
+void FileIndex::materialize(const QSharedPointer<const FileIndexSnapshot> &snapshot, QMap<QUuid,RFileInfo> objects, QHash<QUuid,FileStorage> objectStorage)
+{
+    if (!this->snapshot || this->snapshot != snapshot)
+    {
+        return;
     }
-    QTextStream out(&indexFile);
 
+    for (const QUuid &id : std::as_const(this->shadowed))
+    {
+        objects.remove(id);
+        objectStorage.remove(id);
+    }
     for (auto iter = this->index.cbegin(); iter != this->index.cend(); ++iter)
     {
-        out << this->index.value(iter.key()).toString() << "\n";
+        objects.insert(iter.key(),iter.value());
+    }
+    for (auto iter = this->storage.cbegin(); iter != this->storage.cend(); ++iter)
+    {
+        objectStorage.insert(iter.key(),iter.value());
     }
 
-    indexFile.close();
+    this->index = objects;
+    this->storage = objectStorage;
+    this->shadowed.clear();
+    this->snapshot.reset();
+}
+
+qsizetype FileIndex::readJournal(const QString &fileName)
+{
+    QFile journalFile(fileName);
+    if (!journalFile.exists())
+    {
+        return 0;
+    }
+
+    if(!journalFile.open(QIODevice::ReadOnly))
+    {
+        throw RError(RError::Type::OpenFile,R_ERROR_REF,
+                     "Failed to open index journal file \"%s\" for reading. %s.",
+                     journalFile.fileName().toUtf8().constData(),
+                     journalFile.errorString().toUtf8().constData());
+    }
+
+    QByteArrayList records = journalFile.readAll().split('\n');
+    journalFile.close();
+
+    // Last element is either empty or a record torn by interrupted write.
+    if (!records.isEmpty() && !records.takeLast().isEmpty())
+    {
+        RLogger::warning("[FileIndex] Ignoring incomplete last record in index journal file \"%s\".\n",
+                         fileName.toUtf8().constData());
+    }
+
+    qsizetype nRecords = 0;
+    for (const QByteArray &record : std::as_const(records))
+    {
+        if (record.startsWith("+ "))
+        {
+            this->insertObject(RFileInfo::fromString(QString::fromUtf8(record.sliced(2))));
+            nRecords++;
+        }
+        else if (record.startsWith("- "))
+        {
+            this->takeObject(QUuid::fromString(QLatin1StringView(record.sliced(2))));
+            nRecords++;
+        }
+        else if (record.startsWith("= "))
+        {
+            // Stored form: "= <id> <stored-size> <codec> <checksum-algorithm> <checksum>"
+            // Records written before content checksums were introduced end with codec.
+            QByteArrayList fields = record.sliced(2).split(' ');
+            FileStorage fileStorage;
+            fileStorage.size = fields.value(1).toLongLong();
+            fileStorage.codec = QString::fromUtf8(fields.value(2));
+            fileStorage.checksumAlgorithm = QString::fromUtf8(fields.value(3));
+            fileStorage.checksum = QString::fromUtf8(fields.value(4));
+            this->updateStorage(QUuid::fromString(QLatin1StringView(fields.value(0))),fileStorage);
+            nRecords++;
+        }
+        else if (!record.isEmpty())
+        {
+            RLogger::warning("[FileIndex] Ignoring invalid record in index journal file \"%s\".\n",
+                             fileName.toUtf8().constData());
+        }
+    }
+
+    return nRecords;
+}
+
+qsizetype FileIndex::writeJournal(const QString &fileName)
+{
+    if (this->journalRecords.isEmpty())
+    {
+        return 0;
+    }
+
+    QFile journalFile(fileName);
+    if(!journalFile.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        throw RError(RError::Type::OpenFile,R_ERROR_REF,
+                     "Failed to open index journal file \"%s\" for writing. %s.",
+                     journalFile.fileName().toUtf8().constData(),
+                     journalFile.errorString().toUtf8().constData());
+    }
+
+    QByteArray buffer;
+    for (const QByteArray &record : std::as_const(this->journalRecords))
+    {
+        buffer.append(record);
+        buffer.append('\n');
+    }
+
+    if (journalFile.write(buffer) != buffer.size() || !journalFile.flush())
+    {
+        throw RError(RError::Type::WriteFile,R_ERROR_REF,
+                     "Failed to write index journal file \"%s\". %s.",
+                     journalFile.fileName().toUtf8().constData(),
+                     journalFile.errorString().toUtf8().constData());
+    }
+
+    journalFile.close();
+
+    qsizetype nRecords = this->journalRecords.size();
+    this->journalRecords.clear();
+    return nRecords;
 }
 
 void FileIndex::registerObject(const RFileInfo &fileInfo)
 {
-    this->index.insert(fileInfo.getId(),fileInfo);
+    this->insertObject(fileInfo);
+    this->journalRecords.append("+ " + fileInfo.toString().toUtf8());
+}
+
+void FileIndex::registerObjectStorage(const QUuid &id, const FileStorage &fileStorage)
+{
+    this->updateStorage(id,fileStorage);
+    this->journalRecords.append("= " + id.toString(QUuid::WithoutBraces).toUtf8()
+                                + " " + QByteArray::number(fileStorage.size)
+                                + " " + fileStorage.codec.toUtf8()
+                                + " " + fileStorage.checksumAlgorithm.toUtf8()
+                                + " " + fileStorage.checksum.toUtf8());
 }
 
 RFileInfo FileIndex::unregisterObject(const QUuid &id)
 {
-    return this->index.take(id);
+    this->journalRecords.append("- " + id.toString(QUuid::WithoutBraces).toUtf8());
+    return this->takeObject(id);
 }
 
 bool FileIndex::objectExists(QUuid objectId) const
 {
-    return this->index.contains(objectId);
+    return this->index.contains(objectId) || this->findSnapshotPosition(objectId) >= 0;
 }
 
 RFileInfo FileIndex::getObjectInfo(const QUuid &id) const
 {
-    return this->index[id];
+    auto iter = this->index.constFind(id);
+    if (iter != this->index.cend())
+    {
+        return iter.value();
+    }
+
+    qsizetype position = this->findSnapshotPosition(id);
+    if (position >= 0)
+    {
+        return this->snapshot->getInfo(position);
+    }
+
+    return RFileInfo();
+}
+
+FileStorage FileIndex::getObjectStorage(const QUuid &id) const
+{
+    auto iter = this->index.constFind(id);
+    if (iter != this->index.cend())
+    {
+        return this->findStorage(iter.value());
+    }
+
+    qsizetype position = this->findSnapshotPosition(id);
+    if (position >= 0)
+    {
+        return this->snapshot->getStorage(position);
+    }
+
+    return FileStorage();
+}
+
+QByteArray FileIndex::getObjectJson(const RFileInfo &fileInfo) const
+{
+    QMutexLocker jsonCacheLocker(&this->jsonCacheMutex);
+    auto iter = this->jsonCache.constFind(fileInfo.getId());
+    if (iter != this->jsonCache.cend())
+    {
+        return iter.value();
+    }
+    jsonCacheLocker.unlock();
+
+    // Json is built outside the lock so that concurrent listings do not serialize on it.
+    FileStorage fileStorage = this->getObjectStorage(fileInfo.getId());
+    QJsonObject jsonObject = fileInfo.toJson();
+    jsonObject["etag"] = FileCondition::toEntityTag(FileChecksum::findContentChecksum(fileInfo,fileStorage));
+    if (!fileStorage.checksum.isEmpty())
+    {
+        jsonObject["checksumAlgorithm"] = fileStorage.checksumAlgorithm;
+        jsonObject["checksum"] = fileStorage.checksum;
+    }
+    QByteArray json = QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
+
+    jsonCacheLocker.relock();
+    this->jsonCache.insert(fileInfo.getId(),json);
+    return json;
 }
 
 qsizetype FileIndex::getSize() const
 {
-    return this->index.size();
+    return this->nObjects;
 }
 
-qint64 FileIndex::findStoreSize(const QString &user) const
+QList<QUuid> FileIndex::findPathObjects(const QString &user, const QString &path) const
 {
-    qint64 totalSize = 0;
+    this->buildLookupIndexes();
+    QList<QUuid> ids = this->pathIndex.values(qMakePair(user,path));
+    std::sort(ids.begin(),ids.end());
+    return ids;
+}
 
-    for (auto it = this->index.cbegin(); it != this->index.cend(); ++it)
+QList<QUuid> FileIndex::findTagObjects(const QStringList &tags, bool matchAll) const
+{
+    this->buildLookupIndexes();
+
+    QSet<QUuid> ids;
+
+    if (matchAll)
     {
-        if (user.isEmpty() || user == it.value().getAccessRights().getOwner().getUser())
+        // Start from the smallest set, object must be present in every other one.
+        QList<const QSet<QUuid>*> tagSets;
+        for (const QString &tag : tags)
         {
-            totalSize += it.value().getSize();
+            auto iter = this->tagIndex.constFind(tag);
+            if (iter == this->tagIndex.cend())
+            {
+                return QList<QUuid>();
+            }
+            tagSets.append(&iter.value());
+        }
+        std::sort(tagSets.begin(),tagSets.end(),[](const QSet<QUuid> *a, const QSet<QUuid> *b)
+        {
+            return a->size() < b->size();
+        });
+        if (!tagSets.isEmpty())
+        {
+            ids = *tagSets.first();
+            for (qsizetype i=1;i<tagSets.size() && !ids.isEmpty();i++)
+            {
+                ids.intersect(*tagSets.at(i));
+            }
+        }
+    }
+    else
+    {
+        for (const QString &tag : tags)
+        {
+            auto iter = this->tagIndex.constFind(tag);
+            if (iter != this->tagIndex.cend())
+            {
+                ids.unite(iter.value());
+            }
         }
     }
 
-    return totalSize;
+    QList<QUuid> idList(ids.cbegin(),ids.cend());
+    std::sort(idList.begin(),idList.end());
+    return idList;
 }
 
-qint64 FileIndex::findStoreCount(const QString &user) const
+qsizetype FileIndex::findReferenceCount(const QString &checksum, const QString &codec) const
 {
-    qint64 totalCount = 0;
+    return this->references.value(codec.isEmpty() ? checksum : checksum + "." + codec,0);
+}
 
-    for (auto it = this->index.cbegin(); it != this->index.cend(); ++it)
+qint64 FileIndex::findStoredSize() const
+{
+    return this->totalStoredSize;
+}
+
+FileIndex::Usage FileIndex::findUserUsage(const QString &user) const
+{
+    if (user.isEmpty())
     {
-        if (user.isEmpty() || user == it.value().getAccessRights().getOwner().getUser())
-        {
-            totalCount++;
-        }
+        return this->totalUsage;
     }
+    return this->userUsage.value(user);
+}
 
-    return totalCount;
+qint64 FileIndex::findStoreSize(const QString &user) const
+{
+    return this->findUserUsage(user).size;
 }
 
 QJsonObject FileIndex::getStatisticsJson() const
@@ -143,17 +460,293 @@ QJsonObject FileIndex::getStatisticsJson() const
     RLogger::debug("[%s] Producting statistics\n",QString("FileIndex").toUtf8().constData());
     QJsonObject jObject;
 
-    RRVector fileSize(this->index.count());
+    RRVector fileSize(this->nObjects);
 
     uint i=0;
     for (auto it = this->index.cbegin(); it != this->index.cend(); ++it)
     {
         fileSize[i++] = it.value().getSize();
     }
+    if (this->snapshot)
+    {
+        for (qsizetype position=0;position<this->snapshot->size();position++)
+        {
+            if (!this->shadowed.contains(this->snapshot->getId(position)))
+            {
+                fileSize[i++] = this->snapshot->getSize(position);
+            }
+        }
+    }
 
     jObject["files"] = RStatistics(fileSize).toJson();
     jObject["bytes"] = this->findStoreSize();
+    jObject["storedBytes"] = this->findStoredSize();
     jObject["size"] = this->getSize();
 
     return jObject;
 }
+
+void FileIndex::addUsage(const QString &user, qint64 size, qint64 count)
+{
+    this->totalUsage.size += size;
+    this->totalUsage.count += count;
+
+    Usage &usage = this->userUsage[user];
+    usage.size += size;
+    usage.count += count;
+    if (usage.count <= 0)
+    {
+        this->userUsage.remove(user);
+    }
+}
+
+void FileIndex::addReferences(const QString &checksum, const FileStorage &fileStorage, qsizetype count)
+{
+    if (!this->countReferences)
+    {
+        this->totalStoredSize += count * fileStorage.size;
+        return;
+    }
+
+    // Same content stored with different codecs is kept in different files.
+    QString key = fileStorage.codec.isEmpty() ? checksum : checksum + "." + fileStorage.codec;
+    qsizetype &nReferences = this->references[key];
+    qsizetype nPreviousReferences = nReferences;
+    nReferences += count;
+
+    // Shared content is stored once, its size counts while at least one object references it.
+    if (nPreviousReferences <= 0 && nReferences > 0)
+    {
+        this->totalStoredSize += fileStorage.size;
+    }
+    else if (nPreviousReferences > 0 && nReferences <= 0)
+    {
+        this->totalStoredSize -= fileStorage.size;
+    }
+
+    if (nReferences <= 0)
+    {
+        this->references.remove(key);
+    }
+}
+
+FileStorage FileIndex::findStorage(const RFileInfo &fileInfo) const
+{
+    auto iter = this->storage.constFind(fileInfo.getId());
+    if (iter != this->storage.cend())
+    {
+        return iter.value();
+    }
+    // Raw content has the size of the file.
+    return FileStorage{QString(),fileInfo.getSize()};
+}
+
+void FileIndex::updateStorage(const QUuid &id, const FileStorage &fileStorage)
+{
+    auto iter = this->index.constFind(id);
+    if (iter == this->index.cend())
+    {
+        return;
+    }
+
+    this->dropObjectJson(id);
+    this->addReferences(iter.value().getMd5Checksum(),this->findStorage(iter.value()),-1);
+    if (fileStorage.codec.isEmpty() && fileStorage.checksum.isEmpty())
+    {
+        this->storage.remove(id);
+    }
+    else
+    {
+        this->storage.insert(id,fileStorage);
+    }
+    this->addReferences(iter.value().getMd5Checksum(),this->findStorage(iter.value()),1);
+}
+
+void FileIndex::buildLookupIndexes() const
+{
+    QMutexLocker lookupIndexesLocker(&this->lookupIndexesMutex);
+    if (this->lookupIndexesBuilt)
+    {
+        return;
+    }
+
+    RLogger::debug("[FileIndex] Building path and tag indexes\n");
+
+    for (auto iter = this->index.cbegin(); iter != this->index.cend(); ++iter)
+    {
+        this->pathIndex.insert(qMakePair(iter.value().getAccessRights().getOwner().getUser(),iter.value().getPath()),iter.key());
+        for (const QString &tag : iter.value().getTags())
+        {
+            this->tagIndex[tag].insert(iter.key());
+        }
+    }
+    if (this->snapshot)
+    {
+        // Owner, path and tags are read directly from snapshot records without parsing file information.
+        for (qsizetype position=0;position<this->snapshot->size();position++)
+        {
+            QUuid id = this->snapshot->getId(position);
+            if (this->shadowed.contains(id))
+            {
+                continue;
+            }
+            this->pathIndex.insert(qMakePair(this->snapshot->getOwner(position),this->snapshot->getPath(position)),id);
+            for (const QString &tag : this->snapshot->getTags(position))
+            {
+                this->tagIndex[tag].insert(id);
+            }
+        }
+    }
+
+    this->lookupIndexesBuilt = true;
+}
+
+void FileIndex::addPath(const QString &user, const QString &path, const QUuid &id)
+{
+    // Index is modified only under exclusive access, lookup indexes not built yet will pick the change up.
+    if (!this->lookupIndexesBuilt)
+    {
+        return;
+    }
+    this->pathIndex.insert(qMakePair(user,path),id);
+}
+
+void FileIndex::removePath(const QString &user, const QString &path, const QUuid &id)
+{
+    if (!this->lookupIndexesBuilt)
+    {
+        return;
+    }
+    this->pathIndex.remove(qMakePair(user,path),id);
+}
+
+void FileIndex::addTags(const QStringList &tags, const QUuid &id)
+{
+    if (!this->lookupIndexesBuilt)
+    {
+        return;
+    }
+    for (const QString &tag : tags)
+    {
+        this->tagIndex[tag].insert(id);
+    }
+}
+
+void FileIndex::removeTags(const QStringList &tags, const QUuid &id)
+{
+    if (!this->lookupIndexesBuilt)
+    {
+        return;
+    }
+    for (const QString &tag : tags)
+    {
+        auto iter = this->tagIndex.find(tag);
+        if (iter != this->tagIndex.end())
+        {
+            iter.value().remove(id);
+            if (iter.value().isEmpty())
+            {
+                this->tagIndex.erase(iter);
+            }
+        }
+    }
+}
+
+void FileIndex::dropObjectJson(const QUuid &id)
+{
+    QMutexLocker jsonCacheLocker(&this->jsonCacheMutex);
+    this->jsonCache.remove(id);
+}
+
+qsizetype FileIndex::findSnapshotPosition(const QUuid &id) const
+{
+    if (!this->snapshot || this->shadowed.contains(id))
+    {
+        return -1;
+    }
+    return this->snapshot->find(id);
+}
+
+void FileIndex::insertObject(const RFileInfo &fileInfo)
+{
+    const QUuid id = fileInfo.getId();
+
+    // Stored form is kept when object information is replaced.
+    FileStorage fileStorage;
+
+    auto iter = this->index.constFind(id);
+    if (iter != this->index.cend())
+    {
+        fileStorage = this->findStorage(iter.value());
+        this->addUsage(iter.value().getAccessRights().getOwner().getUser(),-iter.value().getSize(),-1);
+        this->removePath(iter.value().getAccessRights().getOwner().getUser(),iter.value().getPath(),id);
+        this->removeTags(iter.value().getTags(),id);
+        this->addReferences(iter.value().getMd5Checksum(),fileStorage,-1);
+    }
+    else
+    {
+        qsizetype position = this->findSnapshotPosition(id);
+        if (position >= 0)
+        {
+            fileStorage = this->snapshot->getStorage(position);
+            this->addUsage(this->snapshot->getOwner(position),-this->snapshot->getSize(position),-1);
+            this->removePath(this->snapshot->getOwner(position),this->snapshot->getPath(position),id);
+            this->removeTags(this->snapshot->getTags(position),id);
+            this->addReferences(this->snapshot->getChecksum(position),fileStorage,-1);
+            this->shadowed.insert(id);
+        }
+        else
+        {
+            this->nObjects++;
+        }
+    }
+
+    if (fileStorage.codec.isEmpty() && fileStorage.checksum.isEmpty())
+    {
+        this->storage.remove(id);
+    }
+    else
+    {
+        this->storage.insert(id,fileStorage);
+    }
+
+    this->index.insert(id,fileInfo);
+    this->dropObjectJson(id);
+    this->addUsage(fileInfo.getAccessRights().getOwner().getUser(),fileInfo.getSize(),1);
+    this->addPath(fileInfo.getAccessRights().getOwner().getUser(),fileInfo.getPath(),id);
+    this->addTags(fileInfo.getTags(),id);
+    this->addReferences(fileInfo.getMd5Checksum(),this->findStorage(fileInfo),1);
+}
+
+RFileInfo FileIndex::takeObject(const QUuid &id)
+{
+    auto iter = this->index.find(id);
+    if (iter != this->index.end())
+    {
+        RFileInfo fileInfo = iter.value();
+        this->index.erase(iter);
+        this->dropObjectJson(id);
+        this->nObjects--;
+        this->addUsage(fileInfo.getAccessRights().getOwner().getUser(),-fileInfo.getSize(),-1);
+        this->removePath(fileInfo.getAccessRights().getOwner().getUser(),fileInfo.getPath(),id);
+        this->removeTags(fileInfo.getTags(),id);
+        this->addReferences(fileInfo.getMd5Checksum(),this->findStorage(fileInfo),-1);
+        this->storage.remove(id);
+        return fileInfo;
+    }
+
+    qsizetype position = this->findSnapshotPosition(id);
+    if (position >= 0)
+    {
+        this->shadowed.insert(id);
+        this->dropObjectJson(id);
+        this->nObjects--;
+        this->addUsage(this->snapshot->getOwner(position),-this->snapshot->getSize(position),-1);
+        this->removePath(this->snapshot->getOwner(position),this->snapshot->getPath(position),id);
+        this->removeTags(this->snapshot->getTags(position),id);
+        this->addReferences(this->snapshot->getChecksum(position),this->snapshot->getStorage(position),-1);
+        return this->snapshot->getInfo(position);
+    }
+
+    return RFileInfo();
+}
@@ -1,14 +1,28 @@
 #ifndef FILE_INDEX_H
 #define FILE_INDEX_H
 
+#include <QByteArrayList>
+#include <QHash>
 #include <QMap>
+#include <QMultiHash>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QSharedPointer>
 #include <QUuid>
 
 #include <rcl_file_info.h>
 
+#include "file_index_snapshot.h"
+
 class FileIndex
 {
 
+    public:
+
+        //! Store usage.
+        typedef FileUsage Usage;
+
     protected:
 
         //! Internal initialization function.
@@ -16,8 +30,40 @@ class FileIndex
 
     protected:
 
-        //! File info.
+        //! File info (objects changed since snapshot was loaded or all objects once materialized).
         QMap<QUuid,RFileInfo> index;
+        //! Memory mapped index snapshot (null once materialized).
+        QSharedPointer<const FileIndexSnapshot> snapshot;
+        //! Snapshot objects which were replaced or removed.
+        QSet<QUuid> shadowed;
+        //! Number of objects.
+        qsizetype nObjects;
+        //! Store usage per owner user.
+        QHash<QString,Usage> userUsage;
+        //! Total store usage.
+        Usage totalUsage;
+        //! Object IDs by owner user and path (built on first lookup).
+        mutable QMultiHash<QPair<QString,QString>,QUuid> pathIndex;
+        //! Object IDs by tag (built on first lookup).
+        mutable QHash<QString,QSet<QUuid>> tagIndex;
+        //! Path and tag indexes are built.
+        mutable bool lookupIndexesBuilt;
+        //! Lookup indexes mutex (indexes are built by first of concurrent readers).
+        mutable QMutex lookupIndexesMutex;
+        //! Stored form of objects in index which are not stored raw or have content checksum.
+        QHash<QUuid,FileStorage> storage;
+        //! Total size of stored content.
+        qint64 totalStoredSize;
+        //! Count objects referencing the same content.
+        bool countReferences;
+        //! Number of objects by content checksum and codec (only when references are counted).
+        QHash<QString,qsizetype> references;
+        //! Journal records not yet written to journal file.
+        QByteArrayList journalRecords;
+        //! Compact Json of objects by ID (filled on first use, dropped when object changes).
+        mutable QHash<QUuid,QByteArray> jsonCache;
+        //! Json cache mutex (cache is filled by concurrent readers).
+        mutable QMutex jsonCacheMutex;
 
     public:
 
@@ -33,32 +79,82 @@ class FileIndex
         //! Assignment operator.
         FileIndex &operator =(const FileIndex &fileIndex);
 
-        //! Read index from file.
+        //! Enable or disable counting of objects referencing the same content.
+        //! Must be set before the index is read.
+        void setCountReferences(bool countReferences);
+
+        //! Read index from binary snapshot file.
+        //! Snapshot is memory mapped and serves lookups until the index is materialized.
+        //! Usage and references are taken from the snapshot, path and tag indexes are built on first lookup.
         void readFromFile(const QString &fileName);
 
-        //! Read index to file.
+        //! Read index from legacy text file.
+        void readFromTextFile(const QString &fileName);
+
+        //! Write index to binary snapshot file.
         void writeToFile(const QString &fileName) const;
 
-        //! List files for given user.
-        template<typename AccessHandler> QList<RFileInfo> listUserObjects(AccessHandler &&accessHandler) const
+        //! Return snapshot the index is served from (null if index is materialized).
+        QSharedPointer<const FileIndexSnapshot> getSnapshot() const;
+
+        //! Replace snapshot with given objects and their stored form read from it.
+        //! Does nothing if index is no longer served from given snapshot.
+        void materialize(const QSharedPointer<const FileIndexSnapshot> &snapshot, QMap<QUuid,RFileInfo> objects, QHash<QUuid,FileStorage> objectStorage);
+
+        //! Replay journal file on top of the index and return number of replayed records.
+        qsizetype readJournal(const QString &fileName);
+
+        //! Append pending journal records to journal file and return number of written records.
+        qsizetype writeJournal(const QString &fileName);
+
+        //! Call handler for each object in ID order starting from given ID.
+        //! Iteration stops when handler returns false.
+        template<typename Handler> void forEachObject(Handler &&handler, const QUuid &from = QUuid()) const
         {
-            QList<RFileInfo> fileList;
+            auto iter = from.isNull() ? this->index.cbegin() : this->index.lowerBound(from);
+            qsizetype position = 0;
+            qsizetype nSnapshot = 0;
 
-            for (auto iter = this->index.cbegin(); iter != this->index.cend(); ++iter)
+            if (this->snapshot)
             {
-                const RFileInfo &fileInfo = this->index[iter.key()];
-                if (accessHandler(fileInfo))
+                nSnapshot = this->snapshot->size();
+                position = from.isNull() ? 0 : this->snapshot->lowerBound(from);
+            }
+
+            while (iter != this->index.cend() || position < nSnapshot)
+            {
+                if (position < nSnapshot)
+                {
+                    QUuid snapshotId = this->snapshot->getId(position);
+                    if (this->shadowed.contains(snapshotId))
+                    {
+                        position++;
+                        continue;
+                    }
+                    if (iter == this->index.cend() || snapshotId < iter.key())
+                    {
+                        if (!handler(this->snapshot->getInfo(position++)))
+                        {
+                            return;
+                        }
+                        continue;
+                    }
+                }
+                if (!handler(iter.value()))
                 {
-                    fileList.append(fileInfo);
+                    return;
                 }
+                ++iter;
             }
-
-            return fileList;
         }
 
         //! Register file.
+        //! Stored form of already registered file is kept.
         void registerObject(const RFileInfo &fileInfo);
 
+        //! Set stored form of registered file content.
+        void registerObjectStorage(const QUuid &id, const FileStorage &fileStorage);
+
         //! Unregister file.
         RFileInfo unregisterObject(const QUuid &id);
 
@@ -68,18 +164,77 @@ class FileIndex
         //! Get object info.
         RFileInfo getObjectInfo(const QUuid &id) const;
 
+        //! Get stored form of object content.
+        FileStorage getObjectStorage(const QUuid &id) const;
+
+        //! Get compact Json of given object registered in index.
+        QByteArray getObjectJson(const RFileInfo &fileInfo) const;
+
         //! Return size of the index (number of entries).
         qsizetype getSize() const;
 
+        //! Find IDs of objects with given owner user and path.
+        QList<QUuid> findPathObjects(const QString &user, const QString &path) const;
+
+        //! Find IDs of objects having all (matchAll) or any of given tags (sorted).
+        QList<QUuid> findTagObjects(const QStringList &tags, bool matchAll) const;
+
+        //! Find number of objects referencing content with given checksum stored with given codec.
+        qsizetype findReferenceCount(const QString &checksum, const QString &codec) const;
+
+        //! Find total size of stored content.
+        qint64 findStoredSize() const;
+
+        //! Find store usage for given owner user (total usage if user is empty).
+        Usage findUserUsage(const QString &user = QString()) const;
+
         //! Find store size (total file size).
         qint64 findStoreSize(const QString &user = QString()) const;
 
-        //! Find store count (total file count).
-        qint64 findStoreCount(const QString &user = QString()) const;
-
         //! Get statistics output in Json form.
         QJsonObject getStatisticsJson() const;
 
+    protected:
+
+        //! Add to store usage of given owner user.
+        void addUsage(const QString &user, qint64 size, qint64 count);
+
+        //! Add to number of objects referencing content with given checksum and stored form.
+        void addReferences(const QString &checksum, const FileStorage &fileStorage, qsizetype count);
+
+        //! Find stored form of object in index.
+        FileStorage findStorage(const RFileInfo &fileInfo) const;
+
+        //! Set stored form of object in index without journaling.
+        void updateStorage(const QUuid &id, const FileStorage &fileStorage);
+
+        //! Build path and tag indexes if they were not built yet.
+        void buildLookupIndexes() const;
+
+        //! Add object to path index.
+        void addPath(const QString &user, const QString &path, const QUuid &id);
+
+        //! Remove object from path index.
+        void removePath(const QString &user, const QString &path, const QUuid &id);
+
+        //! Add object to tag index.
+        void addTags(const QStringList &tags, const QUuid &id);
+
+        //! Remove object from tag index.
+        void removeTags(const QStringList &tags, const QUuid &id);
+
+        //! Drop cached Json of given object.
+        void dropObjectJson(const QUuid &id);
+
+        //! Find position of visible snapshot object (-1 if not found).
+        qsizetype findSnapshotPosition(const QUuid &id) const;
+
+        //! Insert file into index without journaling.
+        void insertObject(const RFileInfo &fileInfo);
+
+        //! Remove file from index without journaling.
+        RFileInfo takeObject(const QUuid &id);
+
 };
 
 #endif // FILE_INDEX_H
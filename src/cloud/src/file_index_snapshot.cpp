@@ -0,0 +1,441 @@
+#include <cstring>
+
+#include <QHash>
+#include <QList>
+#include <QSaveFile>
+
+#include <rbl_error.h>
+
+#include "file_index_snapshot.h"
+
+const quint32 FileIndexSnapshot::formatVersion = 1;
+
+const char FileIndexSnapshot::magic[8] = {'R','C','I','N','D','E','X','\0'};
+
+FileIndexSnapshot::FileIndexSnapshot(const QString &fileName)
+    : file(fileName)
+    , records(nullptr)
+    , nRecords(0)
+    , usageRecords(nullptr)
+    , nUsageRecords(0)
+    , referenceRecords(nullptr)
+    , nReferenceRecords(0)
+    , storedSize(0)
+    , flags(0)
+    , strings(nullptr)
+    , stringsSize(0)
+{
+    if (!this->file.open(QIODevice::ReadOnly))
+    {
+        throw RError(RError::Type::OpenFile,R_ERROR_REF,
+                     "Failed to open index file \"%s\" for reading. %s.",
+                     this->file.fileName().toUtf8().constData(),
+                     this->file.errorString().toUtf8().constData());
+    }
+
+    quint64 fileSize = quint64(this->file.size());
+    if (fileSize < sizeof(Header))
+    {
+        throw RError(RError::Type::ReadFile,R_ERROR_REF,
+                     "Index file \"%s\" is truncated.",
+                     this->file.fileName().toUtf8().constData());
+    }
+
+    const uchar *data = this->file.map(0,this->file.size());
+    if (!data)
+    {
+        throw RError(RError::Type::ReadFile,R_ERROR_REF,
+                     "Failed to map index file \"%s\". %s.",
+                     this->file.fileName().toUtf8().constData(),
+                     this->file.errorString().toUtf8().constData());
+    }
+
+    const Header *header = reinterpret_cast<const Header*>(data);
+    if (memcmp(header->magic,FileIndexSnapshot::magic,sizeof(FileIndexSnapshot::magic)) != 0)
+    {
+        throw RError(RError::Type::ReadFile,R_ERROR_REF,
+                     "File \"%s\" is not an index file.",
+                     this->file.fileName().toUtf8().constData());
+    }
+    if (header->version != FileIndexSnapshot::formatVersion || header->recordSize != sizeof(Record))
+    {
+        throw RError(RError::Type::ReadFile,R_ERROR_REF,
+                     "Index file \"%s\" has unsupported version %u.",
+                     this->file.fileName().toUtf8().constData(),
+                     quint32(header->version));
+    }
+
+    quint64 recordCount = header->recordCount;
+    quint64 recordsOffset = header->recordsOffset;
+    quint64 usageCount = header->usageCount;
+    quint64 usageOffset = header->usageOffset;
+    quint64 referenceCount = header->referenceCount;
+    quint64 referencesOffset = header->referencesOffset;
+    quint64 stringsOffset = header->stringsOffset;
+    quint64 stringsSize = header->stringsSize;
+
+    if (recordsOffset > fileSize
+        || recordCount > (fileSize - recordsOffset) / sizeof(Record)
+        || usageOffset > fileSize
+        || usageCount > (fileSize - usageOffset) / sizeof(UsageRecord)
+        || referencesOffset > fileSize
+        || referenceCount > (fileSize - referencesOffset) / sizeof(ReferenceRecord)
+        || stringsOffset > fileSize
+        || stringsSize > fileSize - stringsOffset)
+    {
+        throw RError(RError::Type::ReadFile,R_ERROR_REF,
+                     "Index file \"%s\" is corrupted.",
+                     this->file.fileName().toUtf8().constData());
+    }
+
+    this->records = reinterpret_cast<const Record*>(data + recordsOffset);
+    this->nRecords = qsizetype(recordCount);
+    this->usageRecords = reinterpret_cast<const UsageRecord*>(data + usageOffset);
+    this->nUsageRecords = qsizetype(usageCount);
+    this->referenceRecords = reinterpret_cast<const ReferenceRecord*>(data + referencesOffset);
+    this->nReferenceRecords = qsizetype(referenceCount);
+    this->storedSize = header->storedSize;
+    this->flags = header->flags;
+    this->strings = reinterpret_cast<const char*>(data + stringsOffset);
+    this->stringsSize = stringsSize;
+}
+
+FileIndexSnapshot::~FileIndexSnapshot()
+{
+    // Closing the file also unmaps its memory.
+    this->file.close();
+}
+
+qsizetype FileIndexSnapshot::size() const
+{
+    return this->nRecords;
+}
+
+qsizetype FileIndexSnapshot::find(const QUuid &id) const
+{
+    qsizetype position = this->lowerBound(id);
+    if (position < this->nRecords && this->getId(position) == id)
+    {
+        return position;
+    }
+    return -1;
+}
+
+qsizetype FileIndexSnapshot::lowerBound(const QUuid &id) const
+{
+    qsizetype first = 0;
+    qsizetype count = this->nRecords;
+
+    while (count > 0)
+    {
+        qsizetype step = count / 2;
+        qsizetype position = first + step;
+        if (this->getId(position) < id)
+        {
+            first = position + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+QUuid FileIndexSnapshot::getId(qsizetype position) const
+{
+    return QUuid::fromRfc4122(QByteArrayView(this->getRecord(position).id,sizeof(Record::id)));
+}
+
+qint64 FileIndexSnapshot::getSize(qsizetype position) const
+{
+    return this->getRecord(position).size;
+}
+
+QString FileIndexSnapshot::getOwner(qsizetype position) const
+{
+    return this->readString(this->getRecord(position).owner);
+}
+
+QString FileIndexSnapshot::getPath(qsizetype position) const
+{
+    return this->readString(this->getRecord(position).path);
+}
+
+QStringList FileIndexSnapshot::getTags(qsizetype position) const
+{
+    return this->readString(this->getRecord(position).tags).split(',',Qt::SkipEmptyParts);
+}
+
+RFileInfo FileIndexSnapshot::getInfo(qsizetype position) const
+{
+    return RFileInfo::fromString(this->readString(this->getRecord(position).info));
+}
+
+QString FileIndexSnapshot::getChecksum(qsizetype position) const
+{
+    return this->readString(this->getRecord(position).checksum);
+}
+
+FileStorage FileIndexSnapshot::getStorage(qsizetype position) const
+{
+    const Record &record = this->getRecord(position);
+    return FileStorage{this->readString(record.codec),
+                       record.storedSize,
+                       this->readString(record.storedChecksumAlgorithm),
+                       this->readString(record.storedChecksum)};
+}
+
+bool FileIndexSnapshot::hasReferences() const
+{
+    return (this->flags & FileIndexSnapshot::referencesFlag) != 0;
+}
+
+qint64 FileIndexSnapshot::getStoredSize() const
+{
+    return this->storedSize;
+}
+
+QMap<QUuid,RFileInfo> FileIndexSnapshot::readObjects() const
+{
+    QMap<QUuid,RFileInfo> objects;
+
+    // Records are sorted so each insert is appended at the end.
+    for (qsizetype position=0;position<this->nRecords;position++)
+    {
+        objects.insert(objects.cend(),this->getId(position),this->getInfo(position));
+    }
+
+    return objects;
+}
+
+QHash<QUuid,FileStorage> FileIndexSnapshot::readStorage() const
+{
+    QHash<QUuid,FileStorage> storage;
+
+    for (qsizetype position=0;position<this->nRecords;position++)
+    {
+        const Record &record = this->getRecord(position);
+        if (record.codec.length > 0 || record.storedChecksum.length > 0)
+        {
+            storage.insert(this->getId(position),this->getStorage(position));
+        }
+    }
+
+    return storage;
+}
+
+QHash<QString,FileUsage> FileIndexSnapshot::readUsage() const
+{
+    QHash<QString,FileUsage> usage;
+    usage.reserve(this->nUsageRecords);
+
+    for (qsizetype position=0;position<this->nUsageRecords;position++)
+    {
+        const UsageRecord &usageRecord = this->usageRecords[position];
+        usage.insert(this->readString(usageRecord.owner),FileUsage{usageRecord.size,usageRecord.count});
+    }
+
+    return usage;
+}
+
+QHash<QString,qsizetype> FileIndexSnapshot::readReferences() const
+{
+    QHash<QString,qsizetype> references;
+    references.reserve(this->nReferenceRecords);
+
+    for (qsizetype position=0;position<this->nReferenceRecords;position++)
+    {
+        const ReferenceRecord &referenceRecord = this->referenceRecords[position];
+        references.insert(this->readString(referenceRecord.key),qsizetype(referenceRecord.count));
+    }
+
+    return references;
+}
+
+void FileIndexSnapshot::write(const QString &fileName,
+                              qsizetype nObjects,
+                              const std::function<void(const std::function<void(const RFileInfo &, const FileStorage &)> &)> &forEachObject,
+                              const QHash<QString,FileUsage> &userUsage,
+                              const QHash<QString,qsizetype> *references,
+                              qint64 storedSize)
+{
+    // Index is written to temporary file first and then atomically moved in place.
+    QSaveFile indexFile(fileName);
+    if (!indexFile.open(QIODevice::WriteOnly))
+    {
+        throw RError(RError::Type::OpenFile,R_ERROR_REF,
+                     "Failed to open index file \"%s\" for writing. %s.",
+                     indexFile.fileName().toUtf8().constData(),
+                     indexFile.errorString().toUtf8().constData());
+    }
+
+    Header header{};
+    memcpy(header.magic,FileIndexSnapshot::magic,sizeof(FileIndexSnapshot::magic));
+    header.version = FileIndexSnapshot::formatVersion;
+    header.recordSize = quint32(sizeof(Record));
+    header.recordCount = quint64(nObjects);
+    header.recordsOffset = sizeof(Header);
+    header.usageCount = quint64(userUsage.size());
+    header.usageOffset = header.recordsOffset + quint64(nObjects) * sizeof(Record);
+    header.referenceCount = quint64(references ? references->size() : 0);
+    header.referencesOffset = header.usageOffset + header.usageCount * sizeof(UsageRecord);
+    header.storedSize = storedSize;
+    header.flags = references ? FileIndexSnapshot::referencesFlag : 0;
+    header.stringsOffset = header.referencesOffset + header.referenceCount * sizeof(ReferenceRecord);
+
+    bool writeFailed = (indexFile.write(reinterpret_cast<const char*>(&header),sizeof(Header)) != sizeof(Header));
+
+    // Owner and tags strings repeat a lot and are stored once.
+    QHash<QByteArray,quint64> sharedStrings;
+    quint64 stringsSize = 0;
+    qsizetype nWritten = 0;
+
+    auto addString = [&](const QByteArray &string, bool shared, StringRef &stringRef)
+    {
+        stringRef.length = quint32(string.size());
+        stringRef.reserved = 0;
+        if (shared)
+        {
+            auto iter = sharedStrings.constFind(string);
+            if (iter != sharedStrings.cend())
+            {
+                stringRef.offset = iter.value();
+                return;
+            }
+            sharedStrings.insert(string,stringsSize);
+        }
+        stringRef.offset = stringsSize;
+        stringsSize += quint64(string.size());
+    };
+
+    // First pass writes records and assigns string offsets.
+    forEachObject([&](const RFileInfo &fileInfo, const FileStorage &fileStorage)
+    {
+        if (writeFailed || nWritten >= nObjects)
+        {
+            nWritten++;
+            return;
+        }
+
+        Record record{};
+        QByteArray id = fileInfo.getId().toRfc4122();
+        memcpy(record.id,id.constData(),sizeof(Record::id));
+        record.size = fileInfo.getSize();
+        addString(fileInfo.getAccessRights().getOwner().getUser().toUtf8(),true,record.owner);
+        addString(fileInfo.getPath().toUtf8(),false,record.path);
+        addString(fileInfo.getTags().join(',').toUtf8(),true,record.tags);
+        addString(fileInfo.toString().toUtf8(),false,record.info);
+        addString(fileInfo.getMd5Checksum().toUtf8(),true,record.checksum);
+        record.storedSize = fileStorage.size;
+        addString(fileStorage.codec.toUtf8(),true,record.codec);
+        addString(fileStorage.checksumAlgorithm.toUtf8(),true,record.storedChecksumAlgorithm);
+        addString(fileStorage.checksum.toUtf8(),false,record.storedChecksum);
+
+        writeFailed = (indexFile.write(reinterpret_cast<const char*>(&record),sizeof(Record)) != sizeof(Record));
+        nWritten++;
+    });
+
+    if (nWritten != nObjects)
+    {
+        indexFile.cancelWriting();
+        throw RError(RError::Type::WriteFile,R_ERROR_REF,
+                     "Failed to write index file \"%s\". Expected %lld objects but got %lld.",
+                     indexFile.fileName().toUtf8().constData(),
+                     qlonglong(nObjects),
+                     qlonglong(nWritten));
+    }
+
+    // Derived usage and reference tables follow records, their keys are added to string table after object strings.
+    QList<QByteArray> usageOwners;
+    usageOwners.reserve(userUsage.size());
+    for (auto iter = userUsage.cbegin(); iter != userUsage.cend(); ++iter)
+    {
+        UsageRecord usageRecord{};
+        usageOwners.append(iter.key().toUtf8());
+        addString(usageOwners.last(),true,usageRecord.owner);
+        usageRecord.size = iter.value().size;
+        usageRecord.count = iter.value().count;
+        writeFailed = writeFailed || (indexFile.write(reinterpret_cast<const char*>(&usageRecord),sizeof(UsageRecord)) != sizeof(UsageRecord));
+    }
+
+    QList<QByteArray> referenceKeys;
+    if (references)
+    {
+        referenceKeys.reserve(references->size());
+        for (auto iter = references->cbegin(); iter != references->cend(); ++iter)
+        {
+            ReferenceRecord referenceRecord{};
+            referenceKeys.append(iter.key().toUtf8());
+            addString(referenceKeys.last(),true,referenceRecord.key);
+            referenceRecord.count = iter.value();
+            writeFailed = writeFailed || (indexFile.write(reinterpret_cast<const char*>(&referenceRecord),sizeof(ReferenceRecord)) != sizeof(ReferenceRecord));
+        }
+    }
+
+    // Second pass writes string table in the same order offsets were assigned.
+    quint64 position = 0;
+    auto writeString = [&](const QByteArray &string, bool shared)
+    {
+        if (writeFailed || (shared && sharedStrings.value(string) != position))
+        {
+            return;
+        }
+        writeFailed = (indexFile.write(string) != string.size());
+        position += quint64(string.size());
+    };
+
+    forEachObject([&](const RFileInfo &fileInfo, const FileStorage &fileStorage)
+    {
+        writeString(fileInfo.getAccessRights().getOwner().getUser().toUtf8(),true);
+        writeString(fileInfo.getPath().toUtf8(),false);
+        writeString(fileInfo.getTags().join(',').toUtf8(),true);
+        writeString(fileInfo.toString().toUtf8(),false);
+        writeString(fileInfo.getMd5Checksum().toUtf8(),true);
+        writeString(fileStorage.codec.toUtf8(),true);
+        writeString(fileStorage.checksumAlgorithm.toUtf8(),true);
+        writeString(fileStorage.checksum.toUtf8(),false);
+    });
+    for (const QByteArray &owner : std::as_const(usageOwners))
+    {
+        writeString(owner,true);
+    }
+    for (const QByteArray &key : std::as_const(referenceKeys))
+    {
+        writeString(key,true);
+    }
+
+    header.stringsSize = stringsSize;
+
+    if (writeFailed
+        || position != stringsSize
+        || !indexFile.seek(0)
+        || indexFile.write(reinterpret_cast<const char*>(&header),sizeof(Header)) != sizeof(Header)
+        || !indexFile.commit())
+    {
+        QString errorString = indexFile.errorString();
+        indexFile.cancelWriting();
+        throw RError(RError::Type::WriteFile,R_ERROR_REF,
+                     "Failed to write index file \"%s\". %s.",
+                     indexFile.fileName().toUtf8().constData(),
+                     errorString.toUtf8().constData());
+    }
+}
+
+const FileIndexSnapshot::Record &FileIndexSnapshot::getRecord(qsizetype position) const
+{
+    return this->records[position];
+}
+
+QString FileIndexSnapshot::readString(const StringRef &stringRef) const
+{
+    quint64 offset = stringRef.offset;
+    quint64 length = stringRef.length;
+    if (offset > this->stringsSize || length > this->stringsSize - offset)
+    {
+        return QString();
+    }
+    return QString::fromUtf8(this->strings + offset,qsizetype(length));
+}
@@ -0,0 +1,217 @@
+#ifndef FILE_INDEX_SNAPSHOT_H
+#define FILE_INDEX_SNAPSHOT_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+#include <QtEndian>
+#include <QUuid>
+
+#include <functional>
+
+#include <rcl_file_info.h>
+
+#include "file_codec.h"
+
+//! Store usage.
+struct FileUsage
+{
+    //! Total file size.
+    qint64 size = 0;
+    //! Number of files.
+    qint64 count = 0;
+};
+
+//! Binary, memory mapped file index snapshot.
+//!
+//! File layout (little-endian):
+//!   Header | Record[recordCount] sorted by object ID | UsageRecord[usageCount]
+//!          | ReferenceRecord[referenceCount] | string table
+//! Records have fixed size and refer to strings (owner, path, tags,
+//! serialized file information, content checksum, codec and checksum of
+//! stored content) stored in the string table. Owner, tags, checksum and
+//! codec strings are stored only once.
+//! Usage per owner, reference counts and stored size are persisted with the
+//! records so that they do not have to be recounted when snapshot is loaded.
+class FileIndexSnapshot
+{
+
+    Q_DISABLE_COPY(FileIndexSnapshot)
+
+    public:
+
+        //! Format version.
+        static const quint32 formatVersion;
+
+    protected:
+
+        struct StringRef
+        {
+            quint64_le offset;
+            quint32_le length;
+            quint32_le reserved;
+        };
+
+        struct Header
+        {
+            char magic[8];
+            quint32_le version;
+            quint32_le recordSize;
+            quint64_le recordCount;
+            quint64_le recordsOffset;
+            quint64_le usageCount;
+            quint64_le usageOffset;
+            quint64_le referenceCount;
+            quint64_le referencesOffset;
+            qint64_le storedSize;
+            quint32_le flags;
+            quint32_le reserved;
+            quint64_le stringsOffset;
+            quint64_le stringsSize;
+        };
+
+        struct Record
+        {
+            uchar id[16];
+            qint64_le size;
+            StringRef owner;
+            StringRef path;
+            StringRef tags;
+            StringRef info;
+            StringRef checksum;
+            qint64_le storedSize;
+            StringRef codec;
+            StringRef storedChecksumAlgorithm;
+            StringRef storedChecksum;
+        };
+
+        struct UsageRecord
+        {
+            StringRef owner;
+            qint64_le size;
+            qint64_le count;
+        };
+
+        struct ReferenceRecord
+        {
+            StringRef key;
+            qint64_le count;
+        };
+
+        static_assert(sizeof(Header) == 96, "Unexpected index snapshot header size");
+        static_assert(sizeof(Record) == 160, "Unexpected index snapshot record size");
+        static_assert(sizeof(UsageRecord) == 32, "Unexpected index snapshot usage record size");
+        static_assert(sizeof(ReferenceRecord) == 24, "Unexpected index snapshot reference record size");
+
+        //! Header flag set if references were counted when snapshot was written.
+        static const quint32 referencesFlag = 0x1;
+
+        //! File magic.
+        static const char magic[8];
+
+    protected:
+
+        //! Snapshot file.
+        QFile file;
+        //! Pointer to first record.
+        const Record *records;
+        //! Number of records.
+        qsizetype nRecords;
+        //! Pointer to first usage record.
+        const UsageRecord *usageRecords;
+        //! Number of usage records.
+        qsizetype nUsageRecords;
+        //! Pointer to first reference record.
+        const ReferenceRecord *referenceRecords;
+        //! Number of reference records.
+        qsizetype nReferenceRecords;
+        //! Total size of stored content.
+        qint64 storedSize;
+        //! Header flags.
+        quint32 flags;
+        //! Pointer to string table.
+        const char *strings;
+        //! Size of string table.
+        quint64 stringsSize;
+
+    public:
+
+        //! Constructor (maps given file into memory).
+        explicit FileIndexSnapshot(const QString &fileName);
+
+        //! Destructor.
+        ~FileIndexSnapshot();
+
+        //! Return number of records.
+        qsizetype size() const;
+
+        //! Find position of record with given ID (-1 if not found).
+        qsizetype find(const QUuid &id) const;
+
+        //! Find position of first record with ID not less than given ID.
+        qsizetype lowerBound(const QUuid &id) const;
+
+        //! Return object ID at given position.
+        QUuid getId(qsizetype position) const;
+
+        //! Return object size at given position.
+        qint64 getSize(qsizetype position) const;
+
+        //! Return object owner user at given position.
+        QString getOwner(qsizetype position) const;
+
+        //! Return object path at given position.
+        QString getPath(qsizetype position) const;
+
+        //! Return object tags at given position.
+        QStringList getTags(qsizetype position) const;
+
+        //! Return file information at given position.
+        RFileInfo getInfo(qsizetype position) const;
+
+        //! Return content checksum at given position.
+        QString getChecksum(qsizetype position) const;
+
+        //! Return stored form of content at given position.
+        FileStorage getStorage(qsizetype position) const;
+
+        //! Check if references were counted when snapshot was written.
+        bool hasReferences() const;
+
+        //! Return total size of stored content.
+        qint64 getStoredSize() const;
+
+        //! Read all objects.
+        QMap<QUuid,RFileInfo> readObjects() const;
+
+        //! Read stored form of all objects which are not stored raw or have content checksum.
+        QHash<QUuid,FileStorage> readStorage() const;
+
+        //! Read store usage per owner user.
+        QHash<QString,FileUsage> readUsage() const;
+
+        //! Read number of objects by content key (empty unless references were counted).
+        QHash<QString,qsizetype> readReferences() const;
+
+        //! Write snapshot file.
+        //! Function forEachObject must call given function for each of nObjects objects in ID order and is called twice.
+        //! References are written only if given pointer is not null.
+        static void write(const QString &fileName,
+                          qsizetype nObjects,
+                          const std::function<void(const std::function<void(const RFileInfo &, const FileStorage &)> &)> &forEachObject,
+                          const QHash<QString,FileUsage> &userUsage,
+                          const QHash<QString,qsizetype> *references,
+                          qint64 storedSize);
+
+    protected:
+
+        //! Return record at given position.
+        const Record &getRecord(qsizetype position) const;
+
+        //! Read string from string table.
+        QString readString(const StringRef &stringRef) const;
+
+};
+
+#endif // FILE_INDEX_SNAPSHOT_H
@@ -0,0 +1,114 @@
+#include <QJsonArray>
+
+#include "file_list_query.h"
+
+void FileListQuery::_init(const FileListQuery *pFileListQuery)
+{
+    if (pFileListQuery)
+    {
+        this->tags = pFileListQuery->tags;
+        this->tagMatch = pFileListQuery->tagMatch;
+        this->limit = pFileListQuery->limit;
+        this->cursor = pFileListQuery->cursor;
+    }
+}
+
+FileListQuery::FileListQuery()
+    : tagMatch(FileListQuery::All)
+    , limit(0)
+{
+    this->_init();
+}
+
+FileListQuery::FileListQuery(const FileListQuery &fileListQuery)
+{
+    this->_init(&fileListQuery);
+}
+
+FileListQuery::~FileListQuery()
+{
+
+}
+
+FileListQuery &FileListQuery::operator =(const FileListQuery &fileListQuery)
+{
+    this->_init(&fileListQuery);
+    return (*this);
+}
+
+const QStringList &FileListQuery::getTags() const
+{
+    return this->tags;
+}
+
+void FileListQuery::setTags(const QStringList &tags)
+{
+    this->tags = tags;
+}
+
+FileListQuery::TagMatch FileListQuery::getTagMatch() const
+{
+    return this->tagMatch;
+}
+
+void FileListQuery::setTagMatch(TagMatch tagMatch)
+{
+    this->tagMatch = tagMatch;
+}
+
+qsizetype FileListQuery::getLimit() const
+{
+    return this->limit;
+}
+
+void FileListQuery::setLimit(qsizetype limit)
+{
+    this->limit = limit;
+}
+
+const QUuid &FileListQuery::getCursor() const
+{
+    return this->cursor;
+}
+
+void FileListQuery::setCursor(const QUuid &cursor)
+{
+    this->cursor = cursor;
+}
+
+FileListQuery FileListQuery::fromJson(const QJsonObject &json)
+{
+    FileListQuery query;
+
+    if (const QJsonValue &v = json["tags"]; v.isArray())
+    {
+        const QJsonArray &tagsArray = v.toArray();
+        for (const QJsonValue &tag : tagsArray)
+        {
+            query.tags.append(tag.toString());
+        }
+    }
+    if (const QJsonValue &v = json["tagMatch"]; v.isString())
+    {
+        query.tagMatch = FileListQuery::tagMatchFromString(v.toString());
+    }
+    if (const QJsonValue &v = json["limit"]; v.isDouble())
+    {
+        query.limit = qMax(qsizetype(v.toInteger()),qsizetype(0));
+    }
+    if (const QJsonValue &v = json["cursor"]; v.isString())
+    {
+        query.cursor = QUuid::fromString(v.toString());
+    }
+
+    return query;
+}
+
+FileListQuery::TagMatch FileListQuery::tagMatchFromString(const QString &tagMatch)
+{
+    if (tagMatch == "any")
+    {
+        return FileListQuery::Any;
+    }
+    return FileListQuery::All;
+}
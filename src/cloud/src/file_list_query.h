@@ -0,0 +1,83 @@
+#ifndef FILE_LIST_QUERY_H
+#define FILE_LIST_QUERY_H
+
+#include <QJsonObject>
+#include <QStringList>
+#include <QUuid>
+
+class FileListQuery
+{
+
+    public:
+
+        enum TagMatch
+        {
+            //! Object must have all tags.
+            All = 0,
+            //! Object must have at least one of tags.
+            Any
+        };
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const FileListQuery *pFileListQuery = nullptr);
+
+    protected:
+
+        //! Tags to filter by.
+        QStringList tags;
+        //! Tag match mode.
+        TagMatch tagMatch;
+        //! Maximum number of listed objects (0 = unlimited).
+        qsizetype limit;
+        //! List objects with ID greater than cursor (null = from start).
+        QUuid cursor;
+
+    public:
+
+        //! Constructor.
+        FileListQuery();
+
+        //! Copy constructor.
+        FileListQuery(const FileListQuery &fileListQuery);
+
+        //! Destructor.
+        ~FileListQuery();
+
+        //! Assignment operator.
+        FileListQuery &operator =(const FileListQuery &fileListQuery);
+
+        //! Get const reference to tags.
+        const QStringList &getTags() const;
+
+        //! Set tags.
+        void setTags(const QStringList &tags);
+
+        //! Get tag match mode.
+        TagMatch getTagMatch() const;
+
+        //! Set tag match mode.
+        void setTagMatch(TagMatch tagMatch);
+
+        //! Get maximum number of listed objects.
+        qsizetype getLimit() const;
+
+        //! Set maximum number of listed objects.
+        void setLimit(qsizetype limit);
+
+        //! Get cursor.
+        const QUuid &getCursor() const;
+
+        //! Set cursor.
+        void setCursor(const QUuid &cursor);
+
+        //! Create query from Json.
+        static FileListQuery fromJson(const QJsonObject &json);
+
+        //! Convert string to tag match mode.
+        static TagMatch tagMatchFromString(const QString &tagMatch);
+
+};
+
+#endif // FILE_LIST_QUERY_H
@@ -0,0 +1,41 @@
+#include "file_list_writer.h"
+
+FileListWriter::FileListWriter(QByteArray &output)
+    : output(output)
+    , nFiles(0)
+{
+    this->output.clear();
+    this->output.append("{\"files\":[");
+}
+
+FileListWriter::~FileListWriter()
+{
+
+}
+
+void FileListWriter::appendJson(const QByteArray &json)
+{
+    if (this->nFiles > 0)
+    {
+        this->output.append(',');
+    }
+    this->output.append(json);
+    this->nFiles++;
+}
+
+qsizetype FileListWriter::size() const
+{
+    return this->nFiles;
+}
+
+void FileListWriter::finish(const QUuid &nextCursor)
+{
+    this->output.append(']');
+    if (!nextCursor.isNull())
+    {
+        this->output.append(",\"cursor\":\"");
+        this->output.append(nextCursor.toByteArray(QUuid::WithoutBraces));
+        this->output.append('"');
+    }
+    this->output.append('}');
+}
@@ -0,0 +1,39 @@
+#ifndef FILE_LIST_WRITER_H
+#define FILE_LIST_WRITER_H
+
+#include <QByteArray>
+#include <QUuid>
+
+//! Writes file list Json directly into output buffer without building document for the whole list.
+class FileListWriter
+{
+
+    Q_DISABLE_COPY(FileListWriter)
+
+    protected:
+
+        //! Output buffer.
+        QByteArray &output;
+        //! Number of written files.
+        qsizetype nFiles;
+
+    public:
+
+        //! Constructor (starts file list).
+        explicit FileListWriter(QByteArray &output);
+
+        //! Destructor.
+        ~FileListWriter();
+
+        //! Append file given by its compact Json.
+        void appendJson(const QByteArray &json);
+
+        //! Return number of written files.
+        qsizetype size() const;
+
+        //! Finish file list with optional cursor for next page.
+        void finish(const QUuid &nextCursor = QUuid());
+
+};
+
+#endif // FILE_LIST_WRITER_H
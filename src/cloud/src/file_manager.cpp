@@ -1,25 +1,50 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSaveFile>
 
 #include <rbl_error.h>
 #include <rbl_file_tools.h>
 #include <rbl_logger.h>
 
+#include "file_archive.h"
+#include "file_checksum.h"
+#include "file_codec.h"
+#include "file_condition.h"
+#include "file_list_query.h"
+#include "file_list_writer.h"
 #include "file_manager.h"
+#include "file_range.h"
+#include "file_sync.h"
+
+const uint FileManager::maxShardLevels = 4;
 
 FileManager::FileManager(const FileManagerSettings &fileManagerSettings,
                          const UserManager *userManager)
     : settings{fileManagerSettings}
     , userManager{userManager}
     , stopFlag{false}
+    , indexJournalLength{0}
     , totalSize{0}
+    , archiveSizeInProgress{0}
+    , nUnflushedTasks{0}
 {
     R_LOG_TRACE_IN;
     this->setBlocking(false);
     this->setParallel(true);
 
+    this->readerPool.setMaxThreadCount(this->settings.getReaderCount() > 0 ? int(this->settings.getReaderCount()) : QThread::idealThreadCount());
+    RLogger::info("[%s] Number of reader threads: %d\n",
+                  this->settings.getName().toUtf8().constData(),
+                  this->readerPool.maxThreadCount());
+
     this->initialize();
     R_LOG_TRACE_OUT;
 }
@@ -32,119 +57,84 @@ int FileManager::perform()
         this->serviceMutex.lock();
         emit this->ready();
 
-        bool safeStopFlag = false;
-        while (!safeStopFlag)
+        this->materializeIndex();
+
+        this->syncMutex.lock();
+        while (!this->stopFlag)
         {
             RLogger::trace("[%s] Loop\n",this->settings.getName().toUtf8().constData());
-            this->syncMutex.lock();
 
-            if (!this->tasks.isEmpty())
+            if (this->tasks.isEmpty())
             {
-                RLogger::trace("[%s] Processing task\n",this->settings.getName().toUtf8().constData());
-
-                bool writeIndex = false;
-                FileManagerTask task = this->tasks.dequeue();
-                RError::Type resultErrorType = RError::None;
-                QByteArray result;
-
-                if (task.getAction() == FileManagerTask::Action::ListFiles)
-                {
-                    resultErrorType = this->listFiles(task.getExecutor(),result);
-                    writeIndex = false;
-                }
-                else if (task.getAction() == FileManagerTask::Action::FileInfo)
-                {
-                    resultErrorType = this->fileInfo(task.getExecutor(),task.getObject()->getInfo().getId(),result);
-                    writeIndex = false;
-                }
-                else if (task.getAction() == FileManagerTask::Action::StoreFile)
-                {
-                    resultErrorType = this->storeFile(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::ReplaceFile)
-                {
-                    resultErrorType = this->replaceFile(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::UpdateFile)
-                {
-                    resultErrorType = this->updateFile(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::UpdateFileAccessOwner)
-                {
-                    resultErrorType = this->updateFileAccessOwner(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::UpdateFileAccessMode)
-                {
-                    resultErrorType = this->updateFileAccessMode(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::UpdateFileVersion)
-                {
-                    resultErrorType = this->updateFileVersion(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::UpdateFileTags)
-                {
-                    resultErrorType = this->updateFileTags(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = true;
-                }
-                else if (task.getAction() == FileManagerTask::Action::RetrieveFile)
-                {
-                    resultErrorType = this->retrieveFile(task.getExecutor(),*task.getObject(),result);
-                    writeIndex = false;
-                }
-                else if (task.getAction() == FileManagerTask::Action::RemoveFile)
+                // Idle loop wakes up when pending journal flush, group commit or upload session expiry is due.
+                qint64 flushDelay = this->findFlushDelay();
+                if (flushDelay < 0)
                 {
-                    resultErrorType = this->removeFile(task.getExecutor(),task.getObject()->getInfo().getId(),result);
-                    writeIndex = true;
+                    this->taskCondition.wait(&this->syncMutex);
+                    continue;
                 }
-                else
+                if (flushDelay > 0)
                 {
-                    RLogger::error("[%s] Unknown task \"%d\"\n",
-                                   this->settings.getName().toUtf8().constData(),
-                                   task.getAction());
-                    resultErrorType = RError::Unknown;
+                    this->taskCondition.wait(&this->syncMutex,QDeadlineTimer(flushDelay));
+                    continue;
                 }
+                this->syncMutex.unlock();
+                this->flushDue();
+                this->syncMutex.lock();
+                continue;
+            }
+
+            // Drain whole queue so that enqueueing is not blocked while tasks are being processed.
+            QQueue<FileManagerTask> pendingTasks;
+            pendingTasks.swap(this->tasks);
 
-                task.getObject()->getContent().clear();
-                task.getObject()->getContent().push_back(result);
-                task.getObject()->setErrorType(resultErrorType);
+            this->syncMutex.unlock();
 
-                if (writeIndex)
+            while (!pendingTasks.isEmpty())
+            {
+                FileManagerTask task = pendingTasks.dequeue();
+                if (FileManagerTask::isReadOnly(task.getAction()) || FileManagerTask::isIndexIndependent(task.getAction()))
                 {
-                    try
+                    // Exception must not escape pool thread, request is completed with error instead.
+                    this->readerPool.start([this,task]() mutable
                     {
-                        RLogger::info("[%s] Writing index file \"%s\".\n",
-                                      this->settings.getName().toUtf8().constData(),
-                                      this->indexFileName.toUtf8().constData());
-                        this->fileIndex.writeToFile(this->indexFileName);
-                    }
-                    catch (const RError &error)
-                    {
-                        R_LOG_TRACE_OUT;
-                        RLogger::error("[%s] Failed to write index file \"%s\". %s\n",
-                                       this->settings.getName().toUtf8().constData(),
-                                       this->indexFileName.toUtf8().constData(),
-                                       error.getMessage().toUtf8().constData());
-                    }
+                        try
+                        {
+                            this->processTask(task);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            RLogger::error("%s\n",e.what());
+                            this->completeFailedTask(task,QString::fromUtf8(e.what()));
+                        }
+                        catch (const RError &e)
+                        {
+                            RLogger::error("%s\n",e.getMessage().toUtf8().constData());
+                            this->completeFailedTask(task,e.getMessage());
+                        }
+                    });
+                }
+                else
+                {
+                    this->processTask(task);
+                    this->flushDue();
                 }
-
-                emit this->requestCompleted(task.getId(),task.getObjectShared());
             }
 
-            safeStopFlag = this->stopFlag;
+            // Under continuous load journal is flushed and group is committed as soon as they are due.
+            this->flushDue();
 
-            this->syncMutex.unlock();
+            if (this->settings.getJournalLimit() > 0 && this->indexJournalLength >= this->settings.getJournalLimit())
+            {
+                this->compactIndex();
+            }
 
-            QThread::msleep(10);
+            this->syncMutex.lock();
         }
-        this->syncMutex.lock();
         this->stopFlag = false;
         this->syncMutex.unlock();
+        this->flushJournal();
+        this->commitGroup();
         this->serviceMutex.unlock();
     }
     catch (const std::exception &e)
@@ -166,6 +156,7 @@ void FileManager::stop()
                   this->settings.getName().toUtf8().constData());
     this->syncMutex.lock();
     this->stopFlag = true;
+    this->taskCondition.wakeAll();
     this->syncMutex.unlock();
 
     while (!this->serviceMutex.tryLock())
@@ -174,10 +165,21 @@ void FileManager::stop()
     }
     this->serviceMutex.unlock();
 
+    this->readerPool.waitForDone();
+    this->compactionPool.waitForDone();
+
+    // Tasks left in the queue (including those requeued by reader tasks) are failed so that no request is left waiting.
     this->syncMutex.lock();
-    this->tasks.clear();
+    QQueue<FileManagerTask> pendingTasks;
+    pendingTasks.swap(this->tasks);
     this->syncMutex.unlock();
 
+    while (!pendingTasks.isEmpty())
+    {
+        FileManagerTask task = pendingTasks.dequeue();
+        this->completeFailedTask(task,QString("Service has been stopped"));
+    }
+
     RLogger::info("[%s] Service has been stopped.\n",
                   this->settings.getName().toUtf8().constData());
     R_LOG_TRACE_OUT;
@@ -238,11 +240,76 @@ QUuid FileManager::requestRemoveFile(const RUserInfo &executor, FileObject *obje
     return this->enqueueTask(FileManagerTask(executor,FileManagerTask::RemoveFile,object));
 }
 
+QUuid FileManager::requestOpenUploadSession(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::OpenUploadSession,object));
+}
+
+QUuid FileManager::requestStoreUploadChunk(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::StoreUploadChunk,object));
+}
+
+QUuid FileManager::requestUploadSessionStatus(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::UploadSessionStatus,object));
+}
+
+QUuid FileManager::requestCommitUploadSession(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::CommitUploadSession,object));
+}
+
+QUuid FileManager::requestAbortUploadSession(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::AbortUploadSession,object));
+}
+
+QUuid FileManager::requestBatchRemoveFiles(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::BatchRemoveFiles,object));
+}
+
+QUuid FileManager::requestBatchUpdateFileAccessMode(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::BatchUpdateFileAccessMode,object));
+}
+
+QUuid FileManager::requestBatchUpdateFileVersion(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::BatchUpdateFileVersion,object));
+}
+
+QUuid FileManager::requestBatchUpdateFileTags(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::BatchUpdateFileTags,object));
+}
+
+QUuid FileManager::requestRetrieveArchive(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::RetrieveArchive,object));
+}
+
+QUuid FileManager::requestStoreArchive(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::StoreArchive,object));
+}
+
+QUuid FileManager::requestFileMd5Checksum(const RUserInfo &executor, FileObject *object)
+{
+    return this->enqueueTask(FileManagerTask(executor,FileManagerTask::FileMd5Checksum,object));
+}
+
 QJsonObject FileManager::getStatisticsJson() const
 {
     RLogger::debug("[%s] Producting statistics\n",this->settings.getName().toUtf8().constData());
+    QMutexLocker statisticsLocker(&this->statisticsMutex);
     QJsonObject jObject = this->statistics.toJson();
+    statisticsLocker.unlock();
+
+    QReadLocker indexLocker(&this->indexLock);
     jObject["index"] = this->fileIndex.getStatisticsJson();
+    jObject["durability"] = this->settings.getDurability();
     return jObject;
 }
 
@@ -256,6 +323,82 @@ const FileIndex &FileManager::getFileIndex() const
     return this->fileIndex;
 }
 
+QList<FileObject> FileManager::findStoredObjects(const QUuid &after, qsizetype count) const
+{
+    QList<FileObject> objects;
+
+    QReadLocker indexLocker(&this->indexLock);
+    this->fileIndex.forEachObject([&](const RFileInfo &fileInfo)
+    {
+        if (fileInfo.getId() == after)
+        {
+            return true;
+        }
+        FileStorage fileStorage = this->fileIndex.getObjectStorage(fileInfo.getId());
+        FileObject object;
+        object.setInfo(fileInfo);
+        object.setCodec(fileStorage.codec);
+        object.setContentChecksum(FileChecksum::findContentChecksum(fileInfo,fileStorage));
+        objects.append(object);
+        return objects.size() < count;
+    },after);
+
+    return objects;
+}
+
+QString FileManager::findStoredFilePath(const FileObject &object) const
+{
+    return this->findFilePath(object.getInfo(),object.getCodec());
+}
+
+bool FileManager::isStoredObjectCurrent(const FileObject &object) const
+{
+    QReadLocker indexLocker(&this->indexLock);
+    const QUuid &id = object.getInfo().getId();
+    if (!this->fileIndex.objectExists(id))
+    {
+        return false;
+    }
+    FileStorage fileStorage = this->fileIndex.getObjectStorage(id);
+    return (FileChecksum::findContentChecksum(this->fileIndex.getObjectInfo(id),fileStorage) == object.getContentChecksum() &&
+            fileStorage.codec == object.getCodec());
+}
+
+QStringList FileManager::findOrphanFiles() const
+{
+    // Content files are written and registered under exclusive index lock, so every file
+    // modified before the referenced files are collected is either referenced or orphaned.
+    QDateTime collectTime = QDateTime::currentDateTimeUtc();
+
+    QSet<QString> referencedFilePaths;
+    QReadLocker indexLocker(&this->indexLock);
+    this->fileIndex.forEachObject([&](const RFileInfo &fileInfo)
+    {
+        referencedFilePaths.insert(this->findFilePath(fileInfo,this->fileIndex.getObjectStorage(fileInfo.getId()).codec));
+        return true;
+    });
+    indexLocker.unlock();
+
+    QStringList orphanFilePaths;
+    QString dirPath = this->settings.getDeduplicate() ? this->blobPath : this->storePath;
+    const QStringList filePaths = FileManager::findShardedFiles(dirPath,this->settings.getShardLevels());
+    for (const QString &filePath : filePaths)
+    {
+        QFileInfo fileInfo(filePath);
+        // Store directory contains index files as well, content files are named by object ID.
+        if (fileInfo.fileName().endsWith(".part") ||
+            (dirPath == this->storePath && QUuid::fromString(fileInfo.fileName().section('.',0,0)).isNull()) ||
+            referencedFilePaths.contains(fileInfo.absoluteFilePath()) ||
+            fileInfo.lastModified() >= collectTime)
+        {
+            continue;
+        }
+        orphanFilePaths.append(fileInfo.absoluteFilePath());
+    }
+
+    return orphanFilePaths;
+}
+
 void FileManager::initialize()
 {
     R_LOG_TRACE_IN;
@@ -266,7 +409,56 @@ void FileManager::initialize()
     QDir storeDir(this->settings.getFileStore());
 
     this->storePath = storeDir.absolutePath();
-    this->indexFileName = storeDir.absoluteFilePath("index.txt");
+    this->indexFileName = storeDir.absoluteFilePath("index.bin");
+    this->indexJournalFileName = storeDir.absoluteFilePath("index.journal");
+    this->indexCompactionJournalFileName = storeDir.absoluteFilePath("index.journal.old");
+    this->uploadSessionPath = storeDir.absoluteFilePath("sessions");
+    this->blobPath = storeDir.absoluteFilePath("blobs");
+    this->layoutFileName = storeDir.absoluteFilePath("layout.json");
+
+    if (!FileCodec::isSupported(this->settings.getCompression()))
+    {
+        RLogger::warning("[%s] Unsupported compression codec \"%s\". Files will be stored uncompressed.\n",
+                         this->settings.getName().toUtf8().constData(),
+                         this->settings.getCompression().toUtf8().constData());
+        this->settings.setCompression(QString());
+    }
+
+    if (!FileChecksum::isSupported(this->settings.getChecksum()))
+    {
+        RLogger::warning("[%s] Unsupported checksum \"%s\". Using \"%s\" checksum.\n",
+                         this->settings.getName().toUtf8().constData(),
+                         this->settings.getChecksum().toUtf8().constData(),
+                         FileChecksum::md5.toUtf8().constData());
+        this->settings.setChecksum(FileChecksum::md5);
+    }
+
+    // Content addressed store names and counts contents by their MD5 checksum.
+    if (this->settings.getDeduplicate() && this->settings.getChecksum() != FileChecksum::md5)
+    {
+        RLogger::info("[%s] Content addressed store requires \"%s\" checksum.\n",
+                      this->settings.getName().toUtf8().constData(),
+                      FileChecksum::md5.toUtf8().constData());
+        this->settings.setChecksum(FileChecksum::md5);
+    }
+
+    if (!FileSync::isSupported(this->settings.getDurability()))
+    {
+        RLogger::warning("[%s] Unsupported durability \"%s\". Using \"%s\" durability.\n",
+                         this->settings.getName().toUtf8().constData(),
+                         this->settings.getDurability().toUtf8().constData(),
+                         FileSync::Durability::None.toUtf8().constData());
+        this->settings.setDurability(FileSync::Durability::None);
+    }
+
+    if (this->settings.getShardLevels() > FileManager::maxShardLevels)
+    {
+        RLogger::warning("[%s] Number of shard levels %u is too high. Files will be stored in %u shard levels.\n",
+                         this->settings.getName().toUtf8().constData(),
+                         this->settings.getShardLevels(),
+                         FileManager::maxShardLevels);
+        this->settings.setShardLevels(FileManager::maxShardLevels);
+    }
 
     if (!storeDir.exists() && !storeDir.mkpath(this->settings.getFileStore()))
     {
@@ -275,12 +467,41 @@ void FileManager::initialize()
                        this->settings.getFileStore().toUtf8().constData());
     }
 
+    this->fileIndex.setCountReferences(this->settings.getDeduplicate());
+    this->contentCache.setLimits(this->settings.getCacheSize(),this->settings.getCacheMaxFileSize());
+
     try
     {
-        RLogger::info("[%s] Reading index file \"%s\".\n",
+        QString legacyIndexFileName = storeDir.absoluteFilePath("index.txt");
+        if (!QFile::exists(this->indexFileName) && QFile::exists(legacyIndexFileName))
+        {
+            RLogger::info("[%s] Converting legacy index file \"%s\" to \"%s\".\n",
+                          this->settings.getName().toUtf8().constData(),
+                          legacyIndexFileName.toUtf8().constData(),
+                          this->indexFileName.toUtf8().constData());
+            this->fileIndex.readFromTextFile(legacyIndexFileName);
+            this->fileIndex.writeToFile(this->indexFileName);
+            if (!QFile::rename(legacyIndexFileName,legacyIndexFileName + ".bak"))
+            {
+                RLogger::warning("[%s] Failed to rename legacy index file \"%s\".\n",
+                                 this->settings.getName().toUtf8().constData(),
+                                 legacyIndexFileName.toUtf8().constData());
+            }
+        }
+        else
+        {
+            RLogger::info("[%s] Reading index file \"%s\".\n",
+                          this->settings.getName().toUtf8().constData(),
+                          this->indexFileName.toUtf8().constData());
+            this->fileIndex.readFromFile(this->indexFileName);
+        }
+
+        RLogger::info("[%s] Replaying index journal file \"%s\".\n",
                       this->settings.getName().toUtf8().constData(),
-                      this->indexFileName.toUtf8().constData());
-        this->fileIndex.readFromFile(this->indexFileName);
+                      this->indexJournalFileName.toUtf8().constData());
+        this->indexJournalLength = this->fileIndex.readJournal(this->indexCompactionJournalFileName);
+        this->indexJournalLength += this->fileIndex.readJournal(this->indexJournalFileName);
+
         this->totalSize = this->fileIndex.findStoreSize();
     }
     catch (const RError &error)
@@ -290,6 +511,11 @@ void FileManager::initialize()
                        this->indexFileName.toUtf8().constData(),
                        error.getMessage().toUtf8().constData());
     }
+
+    this->migrateFileLayout();
+    this->migrateFileStore();
+    this->loadUploadSessions();
+    this->uploadSessionExpiryTimer.start();
     R_LOG_TRACE_OUT;
 }
 
@@ -304,124 +530,2011 @@ QUuid FileManager::enqueueTask(const FileManagerTask &task)
                    task.getObject()->getInfo().getId().toString(QUuid::WithoutBraces).toUtf8().constData());
     this->syncMutex.lock();
     this->tasks.enqueue(task);
+    this->taskCondition.wakeOne();
     this->syncMutex.unlock();
     R_LOG_TRACE_RETURN(task.getId());
 }
 
-QString FileManager::findFilePath(const RFileInfo &fileInfo) const
-{
-    QDir storeDir(this->storePath);
-    return storeDir.absoluteFilePath(fileInfo.getId().toString(QUuid::WithoutBraces));
-}
-
-RError::Type FileManager::listFiles(const RUserInfo &executor, QByteArray &output) const
+void FileManager::processTask(FileManagerTask &task)
 {
     R_LOG_TRACE_IN;
+    RLogger::trace("[%s] Processing task\n",this->settings.getName().toUtf8().constData());
+
+    this->recordStatisticsValue(FileManagerStatistics::Type::TaskQueueWait,task.getQueueWaitTime());
+
+    // Read-only tasks may run concurrently, modifying tasks require exclusive access to the index.
+    // Tasks which do not access the index run concurrently without holding the index lock.
+    // Lockers release the index lock also when an exception is thrown.
+    bool readOnly = FileManagerTask::isReadOnly(task.getAction());
+    bool indexIndependent = FileManagerTask::isIndexIndependent(task.getAction());
+    QReadLocker indexReadLocker(readOnly ? &this->indexLock : nullptr);
+    QWriteLocker indexWriteLocker((readOnly || indexIndependent) ? nullptr : &this->indexLock);
+
+    bool writeIndex = false;
+    bool readContent = false;
+    bool readArchive = false;
+    bool computeMd5 = false;
+    QList<FileObject> archiveObjects;
+    RError::Type resultErrorType = RError::None;
+    QByteArray result;
+
+    if (task.getAction() == FileManagerTask::Action::ListFiles)
+    {
+        resultErrorType = this->listFiles(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::FileInfo)
+    {
+        resultErrorType = this->fileInfo(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::StoreFile)
+    {
+        resultErrorType = this->storeFile(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::ReplaceFile)
+    {
+        resultErrorType = this->replaceFile(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UpdateFile)
+    {
+        resultErrorType = this->updateFile(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UpdateFileAccessOwner)
+    {
+        resultErrorType = this->updateFileAccessOwner(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UpdateFileAccessMode)
+    {
+        resultErrorType = this->updateFileAccessMode(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UpdateFileVersion)
+    {
+        resultErrorType = this->updateFileVersion(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UpdateFileTags)
+    {
+        resultErrorType = this->updateFileTags(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::RetrieveFile)
+    {
+        resultErrorType = this->retrieveFile(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+        // Content is not read if file was not modified since the time or version client already has.
+        readContent = (resultErrorType == RError::None && !task.getObject()->isNotModified());
+    }
+    else if (task.getAction() == FileManagerTask::Action::RemoveFile)
+    {
+        resultErrorType = this->removeFile(task.getExecutor(),task.getObject()->getInfo().getId(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::OpenUploadSession)
+    {
+        resultErrorType = this->openUploadSession(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::StoreUploadChunk)
+    {
+        resultErrorType = this->storeUploadChunk(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::UploadSessionStatus)
+    {
+        resultErrorType = this->uploadSessionStatus(task.getExecutor(),task.getObject()->getInfo().getId(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::CommitUploadSession)
+    {
+        resultErrorType = this->commitUploadSession(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::AbortUploadSession)
+    {
+        resultErrorType = this->abortUploadSession(task.getExecutor(),task.getObject()->getInfo().getId(),result);
+        writeIndex = false;
+    }
+    else if (task.getAction() == FileManagerTask::Action::BatchRemoveFiles ||
+             task.getAction() == FileManagerTask::Action::BatchUpdateFileAccessMode ||
+             task.getAction() == FileManagerTask::Action::BatchUpdateFileVersion ||
+             task.getAction() == FileManagerTask::Action::BatchUpdateFileTags)
+    {
+        resultErrorType = this->batchFiles(task.getExecutor(),task.getAction(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::RetrieveArchive)
+    {
+        resultErrorType = this->retrieveArchive(task.getExecutor(),*task.getObject(),archiveObjects,result);
+        writeIndex = false;
+        readArchive = (resultErrorType == RError::None);
+    }
+    else if (task.getAction() == FileManagerTask::Action::StoreArchive)
+    {
+        resultErrorType = this->storeArchive(task.getExecutor(),*task.getObject(),result);
+        writeIndex = true;
+    }
+    else if (task.getAction() == FileManagerTask::Action::FileMd5Checksum)
+    {
+        resultErrorType = this->fileMd5Checksum(task.getExecutor(),*task.getObject(),result);
+        writeIndex = false;
+        // Result is set only if MD5 checksum is already known.
+        computeMd5 = (resultErrorType == RError::None && result.isEmpty());
+    }
+    else if (task.getAction() == FileManagerTask::Action::StoreMd5Checksum)
+    {
+        resultErrorType = this->storeMd5Checksum(*task.getObject(),result);
+        writeIndex = true;
+    }
+    else
+    {
+        RLogger::error("[%s] Unknown task \"%d\"\n",
+                       this->settings.getName().toUtf8().constData(),
+                       task.getAction());
+        resultErrorType = RError::Unknown;
+    }
 
-    RLogger::debug("[%s] listFiles: executor=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData());
+    // Index modifications are written to journal in batches.
+    if (writeIndex && this->nUnflushedTasks++ == 0)
+    {
+        this->journalFlushTimer.start();
+    }
+
+    indexReadLocker.unlock();
+    indexWriteLocker.unlock();
+
+    // Modifications are synced to disk without holding the index lock.
+    if (writeIndex && this->settings.getDurability() == FileSync::Durability::Operation)
+    {
+        this->flushJournal();
+        if (!this->syncModifiedPaths() && resultErrorType == RError::None)
+        {
+            result = QString("Failed to sync modifications to disk").toUtf8();
+            resultErrorType = RError::WriteFile;
+        }
+    }
 
-    QList<RFileInfo> files = this->fileIndex.listUserObjects(
-        [=](const RFileInfo &fileInfo)
+    // File content is read without holding the index lock.
+    if (readContent)
+    {
+        resultErrorType = this->readFileContent(*task.getObject(),result);
+    }
+    else if (readArchive)
+    {
+        resultErrorType = this->readArchiveContent(archiveObjects,result);
+    }
+    else if (computeMd5)
+    {
+        resultErrorType = this->fileContentMd5Checksum(*task.getObject(),result);
+        if (resultErrorType == RError::None)
         {
-            return UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read);
+            // Computed checksum is registered in index by modifying task which completes the request.
+            task.setAction(FileManagerTask::Action::StoreMd5Checksum);
+            this->enqueueTask(task);
+            R_LOG_TRACE_OUT;
+            return;
         }
-    );
+    }
 
-    QJsonObject filesJson;
+    task.getObject()->setContent(result);
+    task.getObject()->setErrorType(resultErrorType);
 
-    QJsonArray filesArray;
-    for (const RFileInfo &fileInfo : std::as_const(files))
+    // Completion is signaled once the group is synced to disk.
+    if (writeIndex && this->settings.getDurability() == FileSync::Durability::Group)
     {
-        filesArray.append(fileInfo.toJson());
+        if (this->syncTasks.isEmpty())
+        {
+            this->groupCommitTimer.start();
+        }
+        this->syncTasks.append(task);
+        R_LOG_TRACE_OUT;
+        return;
     }
-    filesJson["files"] = filesArray;
-    output = QJsonDocument(filesJson).toJson();
 
-    R_LOG_TRACE_RETURN(RError::None);
+    emit this->requestCompleted(task.getId(),task.getObjectShared());
+    R_LOG_TRACE_OUT;
 }
 
-RError::Type FileManager::fileInfo(const RUserInfo &executor, const QUuid &id, QByteArray &output) const
+void FileManager::completeFailedTask(FileManagerTask &task, const QString &message)
 {
     R_LOG_TRACE_IN;
+    task.getObject()->setContent(message.toUtf8());
+    task.getObject()->setErrorType(RError::Unknown);
+    emit this->requestCompleted(task.getId(),task.getObjectShared());
+    R_LOG_TRACE_OUT;
+}
 
-    RLogger::debug("[%s] fileInfo: executor=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData());
-
-    if (!this->fileIndex.objectExists(id))
+void FileManager::flushJournal()
+{
+    R_LOG_TRACE_IN;
+    if (this->nUnflushedTasks == 0)
     {
-        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
+        R_LOG_TRACE_OUT;
+        return;
     }
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+    QElapsedTimer flushTimer;
+    flushTimer.start();
 
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read))
+    QWriteLocker indexLocker(&this->indexLock);
+    try
     {
-        output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),id.toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
+        RLogger::debug("[%s] Writing index journal file \"%s\".\n",
                        this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+                       this->indexJournalFileName.toUtf8().constData());
+        // Newly created journal file is durable only once its directory is synced.
+        if (this->settings.getDurability() != FileSync::Durability::None && !QFile::exists(this->indexJournalFileName))
+        {
+            this->addSyncPath(this->storePath);
+        }
+        this->indexJournalLength += this->fileIndex.writeJournal(this->indexJournalFileName);
+        this->addSyncPath(this->indexJournalFileName);
+    }
+    catch (const RError &error)
+    {
+        RLogger::error("[%s] Failed to write index journal file \"%s\". %s\n",
+                       this->settings.getName().toUtf8().constData(),
+                       this->indexJournalFileName.toUtf8().constData(),
+                       error.getMessage().toUtf8().constData());
     }
+    indexLocker.unlock();
 
-    output = QJsonDocument(fileInfo.toJson()).toJson();
+    this->recordStatisticsValue(FileManagerStatistics::Type::JournalFlushDuration,double(flushTimer.elapsed()));
+    this->recordStatisticsValue(FileManagerStatistics::Type::JournalFlushSize,double(this->nUnflushedTasks));
+    this->nUnflushedTasks = 0;
 
-    R_LOG_TRACE_RETURN(RError::None);
+    R_LOG_TRACE_OUT;
 }
 
-RError::Type FileManager::storeFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+qint64 FileManager::findFlushDelay() const
 {
-    R_LOG_TRACE_IN;
-    RLogger::debug("[%s] storeFile: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
-
-    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Write))
+    qint64 flushDelay = -1;
+    if (this->nUnflushedTasks > 0)
     {
-        output = QString("User \"%1\" is not authorized to store file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+        flushDelay = (this->nUnflushedTasks >= qsizetype(this->settings.getJournalFlushCount()))
+                   ? 0
+                   : qMax(qint64(this->settings.getJournalFlushInterval()) - this->journalFlushTimer.elapsed(),qint64(0));
     }
-
-    RFileQuota userStoreQuota(this->fileIndex.findStoreSize(executor.getName())+object.getContent().size(),
-                              object.getContent().size(),
-                              this->fileIndex.findStoreCount(executor.getName())+1);
-
-    if (executor.getFileQuota().quotaExceeded(userStoreQuota))
+    if (!this->syncTasks.isEmpty())
     {
-        output = QString("User file quota exceeded.").toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
+        qint64 groupCommitDelay = qMax(qint64(this->settings.getGroupCommitWindow()) - this->groupCommitTimer.elapsed(),qint64(0));
+        flushDelay = (flushDelay < 0) ? groupCommitDelay : qMin(flushDelay,groupCommitDelay);
+    }
+    qint64 expiryDelay = this->findUploadSessionExpiryDelay();
+    if (expiryDelay >= 0)
+    {
+        flushDelay = (flushDelay < 0) ? expiryDelay : qMin(flushDelay,expiryDelay);
+    }
+    return flushDelay;
+}
+
+void FileManager::flushDue()
+{
+    R_LOG_TRACE_IN;
+    if (this->nUnflushedTasks > 0 &&
+        (this->nUnflushedTasks >= qsizetype(this->settings.getJournalFlushCount()) ||
+         this->journalFlushTimer.elapsed() >= qint64(this->settings.getJournalFlushInterval())))
+    {
+        this->flushJournal();
+    }
+    if (!this->syncTasks.isEmpty() && this->groupCommitTimer.elapsed() >= qint64(this->settings.getGroupCommitWindow()))
+    {
+        this->commitGroup();
+    }
+    if (this->findUploadSessionExpiryDelay() == 0)
+    {
+        this->expireUploadSessions();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+qint64 FileManager::findUploadSessionExpiryDelay() const
+{
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    if (this->settings.getUploadSessionTimeout() == 0 || this->uploadSessions.isEmpty())
+    {
+        return -1;
+    }
+    // Sessions are checked at most once a minute, or more often if timeout is shorter.
+    qint64 checkInterval = qMin(qint64(this->settings.getUploadSessionTimeout()) * 1000,qint64(60000));
+    return qMax(checkInterval - this->uploadSessionExpiryTimer.elapsed(),qint64(0));
+}
+
+void FileManager::addSyncPath(const QString &path)
+{
+    if (this->settings.getDurability() != FileSync::Durability::None)
+    {
+        this->syncPaths.insert(path);
+    }
+}
+
+bool FileManager::syncModifiedPaths()
+{
+    R_LOG_TRACE_IN;
+    if (this->syncPaths.isEmpty())
+    {
+        R_LOG_TRACE_RETURN(true);
+    }
+
+    QElapsedTimer syncTimer;
+    syncTimer.start();
+
+    bool synced = true;
+    for (const QString &path : std::as_const(this->syncPaths))
+    {
+        if (!FileSync::sync(path))
+        {
+            RLogger::error("[%s] Failed to sync \"%s\" to disk.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           path.toUtf8().constData());
+            synced = false;
+        }
+    }
+    this->syncPaths.clear();
+
+    this->recordStatisticsValue(FileManagerStatistics::Type::SyncDuration,double(syncTimer.elapsed()));
+
+    R_LOG_TRACE_RETURN(synced);
+}
+
+void FileManager::commitGroup()
+{
+    R_LOG_TRACE_IN;
+    if (this->syncTasks.isEmpty())
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    // Journal records of the group are written before it is synced.
+    this->flushJournal();
+    bool synced = this->syncModifiedPaths();
+    this->recordStatisticsValue(FileManagerStatistics::Type::GroupCommitSize,double(this->syncTasks.size()));
+
+    for (FileManagerTask &task : this->syncTasks)
+    {
+        if (!synced && task.getObject()->getErrorType() == RError::None)
+        {
+            task.getObject()->setContent(QString("Failed to sync modifications to disk").toUtf8());
+            task.getObject()->setErrorType(RError::WriteFile);
+        }
+        emit this->requestCompleted(task.getId(),task.getObjectShared());
+    }
+    this->syncTasks.clear();
+
+    R_LOG_TRACE_OUT;
+}
+
+void FileManager::compactIndex()
+{
+    R_LOG_TRACE_IN;
+    if (this->compactionPool.activeThreadCount() > 0)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    // Journal records must be on disk before the journal is handed over to compaction.
+    this->flushJournal();
+    this->syncModifiedPaths();
+
+    QWriteLocker indexLocker(&this->indexLock);
+
+    // Records written from now on go to new journal file.
+    // If previous compaction has failed its journal file is kept and current journal stays in place,
+    // replaying it once more on top of new index file is harmless.
+    if (!QFile::exists(this->indexCompactionJournalFileName) &&
+        !QFile::rename(this->indexJournalFileName,this->indexCompactionJournalFileName))
+    {
+        RLogger::error("[%s] Failed to rename index journal file \"%s\" to \"%s\".\n",
+                       this->settings.getName().toUtf8().constData(),
+                       this->indexJournalFileName.toUtf8().constData(),
+                       this->indexCompactionJournalFileName.toUtf8().constData());
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    FileIndex indexSnapshot(this->fileIndex);
+    this->indexJournalLength = 0;
+
+    indexLocker.unlock();
+
+    this->compactionPool.start([this,indexSnapshot]()
+    {
+        try
+        {
+            RLogger::info("[%s] Writing index file \"%s\".\n",
+                          this->settings.getName().toUtf8().constData(),
+                          this->indexFileName.toUtf8().constData());
+            indexSnapshot.writeToFile(this->indexFileName);
+            // Compacted journal may be removed only once new index file is durable.
+            if (this->settings.getDurability() != FileSync::Durability::None && !FileSync::sync(this->storePath))
+            {
+                throw RError(RError::Type::WriteFile,R_ERROR_REF,
+                             "Failed to sync directory \"%s\" to disk.",
+                             this->storePath.toUtf8().constData());
+            }
+            QFile::remove(this->indexCompactionJournalFileName);
+        }
+        catch (const RError &error)
+        {
+            RLogger::error("[%s] Failed to write index file \"%s\". %s\n",
+                           this->settings.getName().toUtf8().constData(),
+                           this->indexFileName.toUtf8().constData(),
+                           error.getMessage().toUtf8().constData());
+        }
+    });
+    R_LOG_TRACE_OUT;
+}
+
+void FileManager::materializeIndex()
+{
+    R_LOG_TRACE_IN;
+    QSharedPointer<const FileIndexSnapshot> indexSnapshot = this->fileIndex.getSnapshot();
+    if (!indexSnapshot)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    // Requests are served from mapped snapshot while objects are being parsed.
+    this->compactionPool.start([this,indexSnapshot]()
+    {
+        RLogger::info("[%s] Loading %lld objects from index snapshot.\n",
+                      this->settings.getName().toUtf8().constData(),
+                      qlonglong(indexSnapshot->size()));
+        QMap<QUuid,RFileInfo> objects = indexSnapshot->readObjects();
+        QHash<QUuid,FileStorage> objectStorage = indexSnapshot->readStorage();
+
+        QWriteLocker indexLocker(&this->indexLock);
+        this->fileIndex.materialize(indexSnapshot,objects,objectStorage);
+        indexLocker.unlock();
+
+        RLogger::info("[%s] Index snapshot has been loaded.\n",
+                      this->settings.getName().toUtf8().constData());
+    });
+    R_LOG_TRACE_OUT;
+}
+
+void FileManager::recordStatisticsValue(const QString &key, double value)
+{
+    QMutexLocker statisticsLocker(&this->statisticsMutex);
+    this->statistics.recordValue(key,value);
+}
+
+void FileManager::recordStatisticsCounter(const QString &key, qsizetype counter)
+{
+    QMutexLocker statisticsLocker(&this->statisticsMutex);
+    this->statistics.recordCounter(key,counter);
+}
+
+QString FileManager::findFilePath(const RFileInfo &fileInfo, const QString &codec) const
+{
+    QString fileName = this->settings.getDeduplicate() ? fileInfo.getMd5Checksum() : fileInfo.getId().toString(QUuid::WithoutBraces);
+    if (!codec.isEmpty())
+    {
+        fileName += "." + codec;
+    }
+    return FileManager::findShardedFilePath(this->settings.getDeduplicate() ? this->blobPath : this->storePath,
+                                            fileName,
+                                            this->settings.getShardLevels());
+}
+
+QString FileManager::findShardedFilePath(const QString &dirPath, const QString &fileName, uint shardLevels)
+{
+    // File names start with object ID or content checksum so their prefixes are evenly distributed.
+    QString filePath(dirPath);
+    for (uint level=0;level<shardLevels;level++)
+    {
+        filePath += "/" + fileName.mid(2 * level,2);
+    }
+    return filePath + "/" + fileName;
+}
+
+QStringList FileManager::findShardedFiles(const QString &dirPath, uint shardLevels)
+{
+    QDir dir(dirPath);
+    QStringList filePaths;
+
+    if (shardLevels == 0)
+    {
+        const QStringList fileNames = dir.entryList(QDir::Files);
+        for (const QString &fileName : fileNames)
+        {
+            filePaths.append(dir.absoluteFilePath(fileName));
+        }
+        return filePaths;
+    }
+
+    // Shard directories have two character names, other directories (blobs, sessions) are skipped.
+    const QStringList shardNames = dir.entryList({"??"},QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &shardName : shardNames)
+    {
+        filePaths.append(FileManager::findShardedFiles(dir.absoluteFilePath(shardName),shardLevels - 1));
+    }
+    return filePaths;
+}
+
+void FileManager::migrateFileLayout()
+{
+    R_LOG_TRACE_IN;
+    // Missing layout file means files are stored flat.
+    uint previousShardLevels = 0;
+    QFile layoutFile(this->layoutFileName);
+    if (layoutFile.open(QIODevice::ReadOnly))
+    {
+        previousShardLevels = QJsonDocument::fromJson(layoutFile.readAll()).object()["shardLevels"].toString().toUInt();
+        layoutFile.close();
+    }
+
+    uint shardLevels = this->settings.getShardLevels();
+    if (previousShardLevels == shardLevels)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    RLogger::info("[%s] Moving files from %u to %u shard levels.\n",
+                  this->settings.getName().toUtf8().constData(),
+                  previousShardLevels,
+                  shardLevels);
+
+    // Sharded path depends on file name only, files of both per-object and content addressed store are moved.
+    qsizetype nMoved = 0;
+    bool moveFailed = false;
+    for (const QString &dirPath : {this->storePath,this->blobPath})
+    {
+        const QStringList filePaths = FileManager::findShardedFiles(dirPath,previousShardLevels);
+        for (const QString &filePath : filePaths)
+        {
+            QString fileName = QFileInfo(filePath).fileName();
+            // Store directory contains index files as well, content files are named by object ID.
+            if (fileName.endsWith(".part") || (dirPath == this->storePath && QUuid::fromString(fileName.section('.',0,0)).isNull()))
+            {
+                continue;
+            }
+            QString newFilePath = FileManager::findShardedFilePath(dirPath,fileName,shardLevels);
+            if (!QDir().mkpath(QFileInfo(newFilePath).absolutePath()) || !QFile::rename(filePath,newFilePath))
+            {
+                RLogger::error("[%s] Failed to move file \"%s\" to \"%s\".\n",
+                               this->settings.getName().toUtf8().constData(),
+                               filePath.toUtf8().constData(),
+                               newFilePath.toUtf8().constData());
+                moveFailed = true;
+                continue;
+            }
+            nMoved++;
+        }
+
+        // Remove shard directories left empty (non-empty directories are kept).
+        std::function<void(const QString &, uint)> removeShards = [&](const QString &shardPath, uint level)
+        {
+            QDir shardDir(shardPath);
+            const QStringList shardNames = shardDir.entryList({"??"},QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const QString &shardName : shardNames)
+            {
+                if (level > 1)
+                {
+                    removeShards(shardDir.absoluteFilePath(shardName),level - 1);
+                }
+                shardDir.rmdir(shardName);
+            }
+        };
+        if (previousShardLevels > 0)
+        {
+            removeShards(dirPath,previousShardLevels);
+        }
+    }
+
+    RLogger::info("[%s] Moved %lld files.\n",
+                  this->settings.getName().toUtf8().constData(),
+                  qlonglong(nMoved));
+
+    // Layout is recorded only once all files are moved so that the migration is retried on next start.
+    if (!moveFailed)
+    {
+        QJsonObject json;
+        json["shardLevels"] = QString::number(shardLevels);
+        QSaveFile newLayoutFile(this->layoutFileName);
+        if (!newLayoutFile.open(QIODevice::WriteOnly) ||
+            newLayoutFile.write(QJsonDocument(json).toJson()) < 0 ||
+            !newLayoutFile.commit())
+        {
+            RLogger::error("[%s] Failed to write store layout file \"%s\". %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           this->layoutFileName.toUtf8().constData(),
+                           newLayoutFile.errorString().toUtf8().constData());
+        }
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void FileManager::migrateFileStore()
+{
+    R_LOG_TRACE_IN;
+    QDir blobDir(this->blobPath);
+
+    if (this->settings.getDeduplicate())
+    {
+        if (!blobDir.exists() && !blobDir.mkpath(this->blobPath))
+        {
+            RLogger::error("[%s] Failed to create path \"%s\".\n",
+                           this->settings.getName().toUtf8().constData(),
+                           this->blobPath.toUtf8().constData());
+            R_LOG_TRACE_OUT;
+            return;
+        }
+
+        // Remove content left from interrupted writes.
+        const QStringList partFileNames = blobDir.entryList({"*.part"},QDir::Files);
+        for (const QString &partFileName : partFileNames)
+        {
+            blobDir.remove(partFileName);
+        }
+
+        // Files stored per object are moved to blobs, duplicate contents are dropped.
+        qsizetype nMoved = 0;
+        qsizetype nDropped = 0;
+        const QStringList filePaths = FileManager::findShardedFiles(this->storePath,this->settings.getShardLevels());
+        for (const QString &filePath : filePaths)
+        {
+            // File name is object ID followed by codec if content is not stored raw.
+            QString fileName = QFileInfo(filePath).fileName();
+            QUuid id = QUuid::fromString(fileName.section('.',0,0));
+            if (id.isNull() || !this->fileIndex.objectExists(id))
+            {
+                continue;
+            }
+
+            QString codec = this->fileIndex.getObjectStorage(id).codec;
+            if (fileName.section('.',1) != codec)
+            {
+                continue;
+            }
+
+            // Blobs are named by MD5 checksum which is not computed for content verified by other checksum.
+            RFileInfo fileInfo = this->fileIndex.getObjectInfo(id);
+            if (fileInfo.getMd5Checksum().isEmpty())
+            {
+                QString md5Checksum;
+                if (!this->computeMd5Checksum(filePath,codec,md5Checksum))
+                {
+                    continue;
+                }
+                fileInfo.setMd5Checksum(md5Checksum);
+                this->fileIndex.registerObject(fileInfo);
+            }
+
+            QString blobFileName = this->findFilePath(fileInfo,codec);
+            if (QFile::exists(blobFileName))
+            {
+                QFile::remove(filePath);
+                nDropped++;
+            }
+            else if (QDir().mkpath(QFileInfo(blobFileName).absolutePath()) && QFile::rename(filePath,blobFileName))
+            {
+                nMoved++;
+            }
+            else
+            {
+                RLogger::error("[%s] Failed to move file \"%s\" to \"%s\".\n",
+                               this->settings.getName().toUtf8().constData(),
+                               filePath.toUtf8().constData(),
+                               blobFileName.toUtf8().constData());
+            }
+        }
+
+        if (nMoved > 0 || nDropped > 0)
+        {
+            RLogger::info("[%s] Moved %lld files to content addressed store, %lld duplicates removed.\n",
+                          this->settings.getName().toUtf8().constData(),
+                          qlonglong(nMoved),
+                          qlonglong(nDropped));
+            try
+            {
+                this->indexJournalLength += this->fileIndex.writeJournal(this->indexJournalFileName);
+            }
+            catch (const RError &error)
+            {
+                RLogger::error("[%s] Failed to write index journal file \"%s\". %s\n",
+                               this->settings.getName().toUtf8().constData(),
+                               this->indexJournalFileName.toUtf8().constData(),
+                               error.getMessage().toUtf8().constData());
+            }
+        }
+    }
+    else if (blobDir.exists())
+    {
+        // Each object gets its own copy of the content, blobs are removed once all objects have one.
+        RLogger::info("[%s] Moving files from content addressed store \"%s\".\n",
+                      this->settings.getName().toUtf8().constData(),
+                      this->blobPath.toUtf8().constData());
+
+        bool copyFailed = false;
+        this->fileIndex.forEachObject([&](const RFileInfo &fileInfo)
+        {
+            QString codec = this->fileIndex.getObjectStorage(fileInfo.getId()).codec;
+            QString suffix = codec.isEmpty() ? QString() : "." + codec;
+            QString fileName = this->findFilePath(fileInfo,codec);
+            QString blobFileName = FileManager::findShardedFilePath(this->blobPath,fileInfo.getMd5Checksum() + suffix,this->settings.getShardLevels());
+            if (!QFile::exists(fileName) &&
+                (!QDir().mkpath(QFileInfo(fileName).absolutePath()) || !QFile::copy(blobFileName,fileName)))
+            {
+                RLogger::error("[%s] Failed to copy content of file id=\"%s\".\n",
+                               this->settings.getName().toUtf8().constData(),
+                               fileInfo.getId().toString(QUuid::WithoutBraces).toUtf8().constData());
+                copyFailed = true;
+            }
+            return true;
+        });
+
+        if (!copyFailed)
+        {
+            blobDir.removeRecursively();
+        }
+    }
+    R_LOG_TRACE_OUT;
+}
+
+bool FileManager::releaseFileContent(const RFileInfo &fileInfo, const FileStorage &fileStorage)
+{
+    if (this->settings.getDeduplicate() && this->fileIndex.findReferenceCount(fileInfo.getMd5Checksum(),fileStorage.codec) > 0)
+    {
+        // Content is still shared by other objects.
+        return true;
+    }
+    QString fileName = this->findFilePath(fileInfo,fileStorage.codec);
+    this->addSyncPath(QFileInfo(fileName).absolutePath());
+    return QFile::remove(fileName);
+}
+
+RError::Type FileManager::listFiles(const RUserInfo &executor, const FileObject &object, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+
+    RLogger::debug("[%s] listFiles: executor=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData());
+
+    FileListQuery query;
+    if (!object.getContent().isEmpty())
+    {
+        QJsonParseError parseError;
+        QJsonDocument queryDocument = QJsonDocument::fromJson(object.getContent(),&parseError);
+        if (parseError.error != QJsonParseError::NoError || !queryDocument.isObject())
+        {
+            output = QString("Invalid list query \"%1\"").arg(parseError.errorString()).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        query = FileListQuery::fromJson(queryDocument.object());
+    }
+
+    // Files are listed in object ID order, entries are written directly to output.
+    FileListWriter writer(output);
+    QUuid lastId;
+    bool hasMore = false;
+
+    auto listFile = [&](const RFileInfo &fileInfo)
+    {
+        if (fileInfo.getId() == query.getCursor() ||
+            !UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read))
+        {
+            return true;
+        }
+        if (query.getLimit() > 0 && writer.size() >= query.getLimit())
+        {
+            hasMore = true;
+            return false;
+        }
+        // Entries are concatenated from Json cached in the index.
+        writer.appendJson(this->fileIndex.getObjectJson(fileInfo));
+        lastId = fileInfo.getId();
+        return true;
+    };
+
+    if (query.getTags().isEmpty())
+    {
+        this->fileIndex.forEachObject(listFile,query.getCursor());
+    }
+    else
+    {
+        // Tag filter is answered from tag index.
+        const QList<QUuid> ids = this->fileIndex.findTagObjects(query.getTags(),query.getTagMatch() == FileListQuery::All);
+        auto iter = query.getCursor().isNull() ? ids.cbegin() : std::upper_bound(ids.cbegin(),ids.cend(),query.getCursor());
+        for (; iter != ids.cend(); ++iter)
+        {
+            if (!listFile(this->fileIndex.getObjectInfo(*iter)))
+            {
+                break;
+            }
+        }
+    }
+
+    writer.finish(hasMore ? lastId : QUuid());
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::fileInfo(const RUserInfo &executor, FileObject &object, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+    const QUuid &id = object.getInfo().getId();
+
+    RLogger::debug("[%s] fileInfo: executor=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(id))
+    {
+        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read))
+    {
+        output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),id.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    bool notModified = false;
+    RError::Type errorType = this->evaluateCondition(fileInfo,
+                                                     FileChecksum::findContentChecksum(fileInfo,this->fileIndex.getObjectStorage(id)),
+                                                     object.getContent(),
+                                                     notModified,
+                                                     output);
+    object.setNotModified(notModified);
+    if (errorType != RError::None || notModified)
+    {
+        R_LOG_TRACE_RETURN(errorType);
+    }
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::storeFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] storeFile: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to store file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    FileIndex::Usage userUsage = this->findUserUsage(executor.getName());
+    qint64 contentSize = FileManager::findContentSize(object);
+    RFileQuota userStoreQuota(userUsage.size+contentSize,
+                              contentSize,
+                              userUsage.count+1);
+
+    if (executor.getFileQuota().quotaExceeded(userStoreQuota))
+    {
+        output = QString("User file quota exceeded.").toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    if (this->settings.getMaxFileSize() > 0)
+    {
+        if (contentSize > this->settings.getMaxFileSize())
+        {
+            output = QString("Invalid file size \"%1 bytes\" (max: \"%2 bytes\")").arg(contentSize).arg(this->settings.getMaxFileSize()).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+    }
+
+    if (this->settings.getMaxStoreSize() > 0)
+    {
+        if (contentSize + this->findStoreSize() > this->settings.getMaxStoreSize())
+        {
+            output = QString("Invalid file size \"%1 bytes\". File store is full.").arg(contentSize).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+    }
+
+    if (!RFileInfo::isPathValid(object.getInfo().getPath()))
+    {
+        output = QString("Invalid path \"%1\"").arg(object.getInfo().getPath()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(object.getInfo());
+    FileStorage fileStorage;
+
+    if (!this->writeFileContent(fileInfo,fileStorage,object))
+    {
+        output = QString("Failed to write file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::WriteFile);
+    }
+
+    this->fileIndex.registerObject(fileInfo);
+    this->fileIndex.registerObjectStorage(fileInfo.getId(),fileStorage);
+
+    this->totalSize += fileInfo.getSize();
+    this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeStore,double(fileInfo.getSize()));
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::replaceFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] replaceFile: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    // List all files with the same path owned by executor.
+    QList<RFileInfo> files;
+    const QList<QUuid> pathObjectIds = this->fileIndex.findPathObjects(executor.getName(),object.getInfo().getPath());
+    for (const QUuid &id : pathObjectIds)
+    {
+        RFileInfo fileInfo = this->fileIndex.getObjectInfo(id);
+        if (UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write)) // File must be writable.
+        {
+            files.append(fileInfo);
+        }
+    }
+
+    QJsonObject jsonOutput;
+    QJsonArray jsonRemoveFileArray;
+
+    // Store new file object.
+    QByteArray uploadFileOutput;
+    RError::Type errorType = this->storeFile(executor,object,uploadFileOutput);
+    if (errorType != RError::None)
+    {
+        output = uploadFileOutput;
+        R_LOG_TRACE_RETURN(errorType);
+    }
+
+    if (!files.isEmpty())
+    {
+        // Remove all replaced files.
+        for (const RFileInfo &fileInfo : std::as_const(files))
+        {
+            QByteArray removeFileOutput;
+            errorType = this->removeFile(executor,fileInfo.getId(),removeFileOutput);
+            jsonRemoveFileArray.append(QJsonDocument::fromJson(removeFileOutput).object());
+            if (errorType != RError::None)
+            {
+                output = uploadFileOutput;
+                R_LOG_TRACE_RETURN(errorType);
+            }
+        }
+    }
+
+    jsonOutput["upload"] = QJsonDocument::fromJson(uploadFileOutput).object();
+    jsonOutput["remove"] = jsonRemoveFileArray;
+
+    output = QJsonDocument(jsonOutput).toJson();
+
+    R_LOG_TRACE_RETURN(errorType);
+}
+
+RError::Type FileManager::updateFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] updateFile: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to update file id=\"%2\"").arg(executor.getName(),fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    FileIndex::Usage userUsage = this->findUserUsage(executor.getName());
+    qint64 contentSize = FileManager::findContentSize(object);
+    RFileQuota userStoreQuota(userUsage.size + contentSize - fileInfo.getSize(),
+                              contentSize - fileInfo.getSize(),
+                              userUsage.count);
+
+    if (executor.getFileQuota().quotaExceeded(userStoreQuota))
+    {
+        output = QString("User file quota exceeded.").toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    if (!RFileInfo::isPathValid(object.getInfo().getPath()))
+    {
+        output = QString("Invalid path \"%1\"").arg(object.getInfo().getPath()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo previousFileInfo(fileInfo);
+    FileStorage previousFileStorage(this->fileIndex.getObjectStorage(fileInfo.getId()));
+    fileInfo.setPath(object.getInfo().getPath());
+    fileInfo.setUpdateDateTime(QDateTime::currentSecsSinceEpoch());
+
+    FileStorage fileStorage;
+    if (!this->writeFileContent(fileInfo,fileStorage,object))
+    {
+        output = QString("Failed to write file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::WriteFile);
+    }
+
+    this->fileIndex.registerObject(fileInfo);
+    this->fileIndex.registerObjectStorage(fileInfo.getId(),fileStorage);
+    this->contentCache.remove(previousFileInfo.getId(),FileChecksum::findContentChecksum(previousFileInfo,previousFileStorage));
+
+    // Previous content is kept in other file if the store is content addressed or if codec has changed.
+    if (this->findFilePath(previousFileInfo,previousFileStorage.codec) != this->findFilePath(fileInfo,fileStorage.codec) &&
+        !this->releaseFileContent(previousFileInfo,previousFileStorage))
+    {
+        RLogger::warning("[%s] Failed to remove previous content of file id=\"%s\".\n",
+                         this->settings.getName().toUtf8().constData(),
+                         fileInfo.getId().toString(QUuid::WithoutBraces).toUtf8().constData());
+    }
+
+    this->totalSize += fileInfo.getSize() - previousFileInfo.getSize();
+    this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeUpdate,double(fileInfo.getSize()));
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::updateFileAccessOwner(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] updateFileAccessOwner: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+
+    if (!object.getInfo().getAccessRights().getOwner().isValid())
+    {
+        output = QString("Invalid access owner").toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RAccessRights accessRights = fileInfo.getAccessRights();
+    accessRights.setOwner(object.getInfo().getAccessRights().getOwner());
+    fileInfo.setAccessRights(accessRights);
+
+    if (!this->userManager->containsUser(fileInfo.getAccessRights().getOwner().getUser()))
+    {
+        output = QString("Invalid access owner user \"%1\"").arg(fileInfo.getAccessRights().getOwner().getUser()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    if (!this->userManager->containsGroup(fileInfo.getAccessRights().getOwner().getGroup()))
+    {
+        output = QString("Invalid access owner group \"%1\"").arg(fileInfo.getAccessRights().getOwner().getGroup()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    this->fileIndex.registerObject(fileInfo);
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::updateFileAccessMode(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] updateFileAccessMode: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::None))
+    {
+        output = QString("User \"%1\" is not authorized to change access mode of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    if (!object.getInfo().getAccessRights().getMode().isValid())
+    {
+        output = QString("Invalid access rights").toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RAccessRights accessRights = fileInfo.getAccessRights();
+    accessRights.setMode(object.getInfo().getAccessRights().getMode());
+    fileInfo.setAccessRights(accessRights);
+
+    this->fileIndex.registerObject(fileInfo);
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::updateFileVersion(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] updateFileVersion: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to change version of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    fileInfo.setVersion(object.getInfo().getVersion());
+
+    this->fileIndex.registerObject(fileInfo);
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::updateFileTags(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] updateFileTags: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to change tags of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    const QStringList &tags = object.getInfo().getTags();
+
+    if (tags.size() > RFileInfo::MaxNumTags)
+    {
+        output = QString("Invalid number of tags \"%1\" (max=\"%2\")").arg(QString::number(tags.size()),QString::number(RFileInfo::MaxNumTags)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    for (const QString &tag : tags)
+    {
+        if (!RFileInfo::isTagValid(tag))
+        {
+            output = QString("Invalid tag \"%1\"").arg(tag).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+    }
+
+    fileInfo.setTags(object.getInfo().getTags());
+
+    this->fileIndex.registerObject(fileInfo);
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::retrieveFile(const RUserInfo &executor, FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] retrieveFile: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    {
+        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    FileStorage fileStorage = this->fileIndex.getObjectStorage(object.getInfo().getId());
+    object.setInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+    object.setCodec(fileStorage.codec);
+    object.setContentChecksum(FileChecksum::findContentChecksum(object.getInfo(),fileStorage));
+
+    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Read))
+    {
+        output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    // Conditions are evaluated on index information so that unchanged file is not touched at all.
+    bool notModified = false;
+    RError::Type errorType = this->evaluateCondition(object.getInfo(),object.getContentChecksum(),object.getContent(),notModified,output);
+    object.setNotModified(notModified);
+    if (errorType != RError::None || notModified)
+    {
+        R_LOG_TRACE_RETURN(errorType);
+    }
+
+    // Content is read by readFileContent() once index lock is released.
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::evaluateCondition(const RFileInfo &fileInfo, const QString &contentChecksum, const QByteArray &request, bool &notModified, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+    notModified = false;
+    output.clear();
+    if (request.isEmpty())
+    {
+        R_LOG_TRACE_RETURN(RError::None);
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument requestDocument = QJsonDocument::fromJson(request,&parseError);
+    if (parseError.error != QJsonParseError::NoError || !requestDocument.isObject())
+    {
+        output = QString("Invalid request \"%1\"").arg(parseError.errorString()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    FileCondition condition;
+    try
+    {
+        condition = FileCondition::fromJson(requestDocument.object());
+    }
+    catch (const RError &error)
+    {
+        output = error.getMessage().toUtf8();
+        RLogger::error("[%s] %s\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    if (condition.isNotModified(fileInfo,contentChecksum))
+    {
+        RLogger::debug("[%s] File id=\"%s\" was not modified.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       fileInfo.getId().toString(QUuid::WithoutBraces).toUtf8().constData());
+        notModified = true;
+        output = FileCondition::toNotModifiedResponse(fileInfo,contentChecksum);
+    }
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+qint64 FileManager::findContentSize(const FileObject &object)
+{
+    if (object.getContentFiles().isEmpty())
+    {
+        return object.getContent().size();
+    }
+
+    qint64 contentSize = 0;
+    for (const QString &contentFile : object.getContentFiles())
+    {
+        contentSize += QFileInfo(contentFile).size();
+    }
+    return contentSize;
+}
+
+bool FileManager::writeFileContent(RFileInfo &fileInfo, FileStorage &fileStorage, const FileObject &object)
+{
+    R_LOG_TRACE_IN;
+    // Content is written to temporary file in store directory which is renamed in place on commit.
+    // Size and checksum are computed while writing so that the file does not need to be read back.
+    // Content addressed blob is known only once the checksum is computed, content is staged next to it.
+    // Content is stored compressed if compression is configured, each frame is compressed only if it compresses well.
+    // Content is synced on commit unless durability is left to the operating system.
+    FileSaveFile file(QString(),this->settings.getDurability() != FileSync::Durability::None);
+    QString fileName;
+    FileChecksum checksum(this->settings.getChecksum());
+    qint64 bufferSize = qMax(this->settings.getWriteBufferSize(),qint64(4096));
+    qint64 position = 0;
+
+    fileStorage = FileStorage();
+
+    auto openFile = [&](const QString &codec)
+    {
+        fileStorage.codec = codec;
+        fileName = this->settings.getDeduplicate()
+                   ? QDir(this->blobPath).absoluteFilePath(fileInfo.getId().toString(QUuid::WithoutBraces) + ".part")
+                   : this->findFilePath(fileInfo,codec);
+        file.setFileName(fileName);
+        if (!QDir().mkpath(QFileInfo(fileName).absolutePath()) || !file.open())
+        {
+            RLogger::error("[%s] Failed to open file \"%s\" for writing. %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           file.fileName().toUtf8().constData(),
+                           file.errorString().toUtf8().constData());
+            return false;
+        }
+        return true;
+    };
+
+    auto writeData = [&](QByteArrayView data)
+    {
+        if (file.write(data.data(),data.size()) != data.size())
+        {
+            RLogger::error("[%s] Failed to write file \"%s\". %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           file.fileName().toUtf8().constData(),
+                           file.errorString().toUtf8().constData());
+            return false;
+        }
+        fileStorage.size += data.size();
+        return true;
+    };
+
+    auto writeChunk = [&](QByteArrayView chunk)
+    {
+        checksum.addData(chunk);
+        position += chunk.size();
+
+        if (!file.isOpen() && !openFile(this->settings.getCompression()))
+        {
+            return false;
+        }
+        return fileStorage.codec.isEmpty() ? writeData(chunk) : writeData(FileCodec::encodeFrame(chunk));
+    };
+
+    bool writeFailed = false;
+    if (object.getContentFiles().isEmpty())
+    {
+        const QByteArray &content = object.getContent();
+        while (!writeFailed && position < content.size())
+        {
+            writeFailed = !writeChunk(QByteArrayView(content.constData() + position,qMin(bufferSize,content.size() - position)));
+        }
+    }
+    else
+    {
+        // Content parts are copied one buffer at a time.
+        QByteArray buffer(bufferSize,Qt::Uninitialized);
+        for (const QString &contentFileName : object.getContentFiles())
+        {
+            QFile contentFile(contentFileName);
+            if (!contentFile.open(QIODevice::ReadOnly))
+            {
+                RLogger::error("[%s] Failed to open file \"%s\" for reading. %s.\n",
+                               this->settings.getName().toUtf8().constData(),
+                               contentFile.fileName().toUtf8().constData(),
+                               contentFile.errorString().toUtf8().constData());
+                writeFailed = true;
+                break;
+            }
+            qint64 nBytes = 0;
+            while (!writeFailed && (nBytes = contentFile.read(buffer.data(),bufferSize)) > 0)
+            {
+                writeFailed = !writeChunk(QByteArrayView(buffer.constData(),nBytes));
+            }
+            if (writeFailed || nBytes < 0)
+            {
+                writeFailed = true;
+                break;
+            }
+        }
+    }
+
+    // Empty content.
+    if (!writeFailed && !file.isOpen())
+    {
+        writeFailed = !openFile(QString());
+    }
+
+    if (writeFailed)
+    {
+        file.cancelWriting();
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    if (!file.commit())
+    {
+        RLogger::error("[%s] Failed to commit file \"%s\". %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       file.fileName().toUtf8().constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    // MD5 checksum of content verified by other checksum is computed once it is requested.
+    fileInfo.setSize(position);
+    if (checksum.getAlgorithm() == FileChecksum::md5)
+    {
+        fileInfo.setMd5Checksum(checksum.result());
+    }
+    else
+    {
+        fileInfo.setMd5Checksum(QString());
+        fileStorage.checksumAlgorithm = checksum.getAlgorithm();
+        fileStorage.checksum = checksum.result();
+    }
+
+    if (this->settings.getDeduplicate())
+    {
+        QString blobFileName = this->findFilePath(fileInfo,fileStorage.codec);
+        if (QFile::exists(blobFileName))
+        {
+            // Identical content is already stored.
+            QFile::remove(fileName);
+        }
+        else if (!QDir().mkpath(QFileInfo(blobFileName).absolutePath()) || !QFile::rename(fileName,blobFileName))
+        {
+            RLogger::error("[%s] Failed to move file \"%s\" to \"%s\".\n",
+                           this->settings.getName().toUtf8().constData(),
+                           fileName.toUtf8().constData(),
+                           blobFileName.toUtf8().constData());
+            QFile::remove(fileName);
+            R_LOG_TRACE_RETURN(false);
+        }
+    }
+
+    // Content is synced on commit, renamed file is durable once its directory is synced.
+    this->addSyncPath(QFileInfo(this->findFilePath(fileInfo,fileStorage.codec)).absolutePath());
+
+    R_LOG_TRACE_RETURN(true);
+}
+
+RError::Type FileManager::readFileContent(const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    const RFileInfo &fileInfo = object.getInfo();
+
+    // Optional request body selects single byte range.
+    bool hasRange = false;
+    FileRange range;
+    if (!object.getContent().isEmpty())
+    {
+        QJsonParseError parseError;
+        QJsonDocument requestDocument = QJsonDocument::fromJson(object.getContent(),&parseError);
+        if (parseError.error != QJsonParseError::NoError || !requestDocument.isObject())
+        {
+            output = QString("Invalid download request \"%1\"").arg(parseError.errorString()).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        if (const QJsonValue &v = requestDocument.object()["range"]; v.isString())
+        {
+            try
+            {
+                range = FileRange::fromString(v.toString());
+                hasRange = true;
+            }
+            catch (const RError &error)
+            {
+                output = error.getMessage().toUtf8();
+                RLogger::error("[%s] %s\n",
+                               this->settings.getName().toUtf8().constData(),
+                               output.constData());
+                R_LOG_TRACE_RETURN(RError::InvalidInput);
+            }
+        }
+    }
+
+    // Range is resolved against logical size recorded in the index (compressed content is stored smaller).
+    qint64 fileSize = fileInfo.getSize();
+    qint64 offset = 0;
+    qint64 length = fileSize;
+    if (hasRange && !range.resolve(fileSize,offset,length))
+    {
+        output = QString("Range \"%1\" is not satisfiable for file id=\"%2\" of size \"%3\"").arg(range.toString(),fileInfo.getId().toString(QUuid::WithoutBraces)).arg(fileSize).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    // Optional limit of memory per download applies regardless of whether the content is cached.
+    if (this->settings.getRetrieveMaxSize() > 0 && length > this->settings.getRetrieveMaxSize())
+    {
+        output = QString("Requested length \"%1\" of file id=\"%2\" exceeds maximum retrieve size \"%3\", download the file by ranges").arg(length).arg(fileInfo.getId().toString(QUuid::WithoutBraces)).arg(this->settings.getRetrieveMaxSize()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    // Cached content is shared with the cache, range is served from it without touching the disk.
+    QByteArray cachedContent;
+    if (this->contentCache.find(fileInfo.getId(),object.getContentChecksum(),cachedContent))
+    {
+        this->recordStatisticsCounter(FileManagerStatistics::Type::CacheHit,1);
+        output = hasRange ? cachedContent.mid(offset,length) : cachedContent;
+        this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeRetrieve,double(length));
+        R_LOG_TRACE_RETURN(RError::None);
+    }
+    this->recordStatisticsCounter(FileManagerStatistics::Type::CacheMiss,1);
+
+    QFile file(this->findFilePath(fileInfo,object.getCodec()));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        output = QString("Failed to read file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s. %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(RError::ReadFile);
+    }
+
+    bool compressed = !object.getCodec().isEmpty();
+    if (!compressed && offset > 0 && !file.seek(offset))
+    {
+        output = QString("Failed to read file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s. %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(RError::ReadFile);
+    }
+
+    // Output is allocated once and filled directly.
+    output = QByteArray(length,Qt::Uninitialized);
+
+    if (!this->readStoredContent(file,compressed,offset,length,output.data()))
+    {
+        output = QString(compressed ? "Failed to decode file id=\"%1\"" : "Failed to read file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s. %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(RError::ReadFile);
+    }
+    file.close();
+
+    // Only whole contents are cached.
+    if (!hasRange && this->contentCache.isCacheable(length))
+    {
+        qsizetype nEvicted = this->contentCache.insert(fileInfo.getId(),object.getContentChecksum(),output);
+        if (nEvicted > 0)
+        {
+            this->recordStatisticsCounter(FileManagerStatistics::Type::CacheEviction,nEvicted);
+        }
+    }
+
+    this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeRetrieve,double(length));
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+bool FileManager::readStoredContent(QFile &file, bool compressed, qint64 offset, qint64 length, char *data) const
+{
+    // Compressed frames are decompressed one at a time directly into data.
+    if (compressed)
+    {
+        return FileCodec::decode(file,offset,length,data);
+    }
+
+    // Raw content is read in chunks of configured buffer size from current position.
+    qint64 bufferSize = qMax(this->settings.getReadBufferSize(),qint64(4096));
+    qint64 position = 0;
+    while (position < length)
+    {
+        qint64 nBytes = file.read(data + position,qMin(bufferSize,length - position));
+        if (nBytes <= 0)
+        {
+            return false;
+        }
+        position += nBytes;
+    }
+    return true;
+}
+
+RError::Type FileManager::retrieveArchive(const RUserInfo &executor, const FileObject &object, QList<FileObject> &archiveObjects, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] retrieveArchive: executor=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData());
+
+    QJsonParseError parseError;
+    QJsonDocument requestDocument = QJsonDocument::fromJson(object.getContent(),&parseError);
+    if (parseError.error != QJsonParseError::NoError || !requestDocument.isObject())
+    {
+        output = QString("Invalid archive request \"%1\"").arg(parseError.errorString()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+    QJsonObject request = requestDocument.object();
+
+    qint64 archiveSize = FileArchive::findEndSize();
+
+    auto addObject = [&](const RFileInfo &fileInfo)
+    {
+        FileObject archiveObject;
+        archiveObject.setInfo(fileInfo);
+        FileStorage fileStorage = this->fileIndex.getObjectStorage(fileInfo.getId());
+        archiveObject.setCodec(fileStorage.codec);
+        archiveObject.setContentChecksum(FileChecksum::findContentChecksum(fileInfo,fileStorage));
+        archiveObjects.append(archiveObject);
+        archiveSize += FileArchive::findEntrySize(fileInfo.getSize());
+    };
+
+    if (request.contains("ids"))
+    {
+        // Explicitly requested files must all exist and be readable.
+        const QJsonArray jIds = request["ids"].toArray();
+        for (const QJsonValue &jId : jIds)
+        {
+            QUuid id = QUuid::fromString(jId.toString());
+            if (id.isNull() || !this->fileIndex.objectExists(id))
+            {
+                output = QString("File object \"%1\" does not exist").arg(jId.toString()).toUtf8();
+                RLogger::error("[%s] %s.\n",
+                               this->settings.getName().toUtf8().constData(),
+                               output.constData());
+                R_LOG_TRACE_RETURN(RError::InvalidInput);
+            }
+            RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+            if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read))
+            {
+                output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),id.toString(QUuid::WithoutBraces)).toUtf8();
+                RLogger::error("[%s] %s.\n",
+                               this->settings.getName().toUtf8().constData(),
+                               output.constData());
+                R_LOG_TRACE_RETURN(RError::Unauthorized);
+            }
+            addObject(fileInfo);
+        }
+    }
+    else
+    {
+        // Tag selection is answered from tag index, files the executor cannot read are left out.
+        FileListQuery query = FileListQuery::fromJson(request);
+        if (query.getTags().isEmpty())
+        {
+            output = QString("Archive request must contain file ids or tags").toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        const QList<QUuid> ids = this->fileIndex.findTagObjects(query.getTags(),query.getTagMatch() == FileListQuery::All);
+        for (const QUuid &id : ids)
+        {
+            RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+            if (UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Read))
+            {
+                addObject(fileInfo);
+            }
+        }
+    }
+
+    if (this->settings.getArchiveMaxSize() > 0 && archiveSize > this->settings.getArchiveMaxSize())
+    {
+        output = QString("Archive size \"%1\" exceeds maximum archive size \"%2\"").arg(archiveSize).arg(this->settings.getArchiveMaxSize()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    // Content is read by readArchiveContent() once index lock is released.
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::readArchiveContent(const QList<FileObject> &archiveObjects, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+
+    qint64 archiveSize = FileArchive::findEndSize();
+    for (const FileObject &archiveObject : archiveObjects)
+    {
+        archiveSize += FileArchive::findEntrySize(archiveObject.getInfo().getSize());
+    }
+
+    // Archives assembled at the same time share memory budget, requests past it are rejected.
+    QMutexLocker archiveLocker(&this->archiveMutex);
+    if (this->settings.getArchiveMemoryLimit() > 0 && this->archiveSizeInProgress + archiveSize > this->settings.getArchiveMemoryLimit())
+    {
+        archiveLocker.unlock();
+        output = QString("Archive size \"%1\" exceeds memory available for archives, try again later").arg(archiveSize).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+    this->archiveSizeInProgress += archiveSize;
+    archiveLocker.unlock();
+
+    // Budget is returned also when allocation fails.
+    RError::Type errorType = RError::None;
+    try
+    {
+        errorType = this->assembleArchive(archiveObjects,archiveSize,output);
+    }
+    catch (...)
+    {
+        archiveLocker.relock();
+        this->archiveSizeInProgress -= archiveSize;
+        throw;
+    }
+
+    archiveLocker.relock();
+    this->archiveSizeInProgress -= archiveSize;
+    archiveLocker.unlock();
+
+    R_LOG_TRACE_RETURN(errorType);
+}
+
+RError::Type FileManager::assembleArchive(const QList<FileObject> &archiveObjects, qint64 archiveSize, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+
+    // Response body is a single buffer, so the whole archive is held in memory and is not streamed.
+    // It is allocated once and entries are read directly into it.
+    output = QByteArray(archiveSize,Qt::Uninitialized);
+    char *data = output.data();
+    qint64 position = 0;
+
+    for (const FileObject &archiveObject : archiveObjects)
+    {
+        const RFileInfo &fileInfo = archiveObject.getInfo();
+        qint64 length = fileInfo.getSize();
+        qint64 entrySize = FileArchive::findEntrySize(length);
+
+        // Files without usable path are stored under their ID.
+        QString entryName = FileArchive::findEntryName(fileInfo.getPath());
+        if (!FileArchive::writeHeader(entryName,length,fileInfo.getUpdateDateTime(),data + position))
+        {
+            FileArchive::writeHeader(fileInfo.getId().toString(QUuid::WithoutBraces),length,fileInfo.getUpdateDateTime(),data + position);
+        }
+        char *content = data + position + FileArchive::blockSize;
+
+        QByteArray cachedContent;
+        if (this->contentCache.find(fileInfo.getId(),archiveObject.getContentChecksum(),cachedContent) && cachedContent.size() == length)
+        {
+            this->recordStatisticsCounter(FileManagerStatistics::Type::CacheHit,1);
+            memcpy(content,cachedContent.constData(),size_t(length));
+        }
+        else
+        {
+            this->recordStatisticsCounter(FileManagerStatistics::Type::CacheMiss,1);
+            QFile file(this->findFilePath(fileInfo,archiveObject.getCodec()));
+            if (!file.open(QIODevice::ReadOnly) || !this->readStoredContent(file,!archiveObject.getCodec().isEmpty(),0,length,content))
+            {
+                QString errorString = file.errorString();
+                output = QString("Failed to read file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+                RLogger::error("[%s] %s. %s.\n",
+                               this->settings.getName().toUtf8().constData(),
+                               output.constData(),
+                               errorString.toUtf8().constData());
+                R_LOG_TRACE_RETURN(RError::ReadFile);
+            }
+        }
+
+        memset(content + length,0,size_t(entrySize - FileArchive::blockSize - length));
+        position += entrySize;
+
+        this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeRetrieve,double(length));
+    }
+
+    memset(data + position,0,size_t(FileArchive::findEndSize()));
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::storeArchive(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] storeArchive: executor=\"%s\", storePath=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   this->storePath.toUtf8().constData());
+
+    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to store files").arg(executor.getName()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+
+    const QByteArray &archive = object.getContent();
+    QList<FileArchive::Entry> entries;
+    try
+    {
+        entries = FileArchive::readEntries(archive);
+    }
+    catch (const RError &error)
+    {
+        output = error.getMessage().toUtf8();
+        RLogger::error("[%s] %s\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    if (this->settings.getMaxFileSize() > 0)
+    // Whole archive is validated before anything is written.
+    QString pathPrefix = object.getInfo().getPath();
+    while (pathPrefix.endsWith('/'))
+    {
+        pathPrefix.chop(1);
+    }
+
+    QStringList paths;
+    qint64 totalContentSize = 0;
+    qint64 maxContentSize = 0;
+    for (const FileArchive::Entry &entry : std::as_const(entries))
     {
-        if (object.getContent().size() > this->settings.getMaxFileSize())
+        QString entryName = FileArchive::findEntryName(entry.name);
+        QString path = pathPrefix.isEmpty() ? entryName : pathPrefix + '/' + entryName;
+        if (entryName.isEmpty() || !RFileInfo::isPathValid(path))
+        {
+            output = QString("Invalid archive member path \"%1\"").arg(entry.name).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        if (this->settings.getMaxFileSize() > 0 && entry.size > this->settings.getMaxFileSize())
         {
-            output = QString("Invalid file size \"%1 bytes\" (max: \"%2 bytes\")").arg(object.getContent().size()).arg(this->settings.getMaxFileSize()).toUtf8();
+            output = QString("Invalid file size \"%1 bytes\" of archive member \"%2\" (max: \"%3 bytes\")").arg(entry.size).arg(entry.name).arg(this->settings.getMaxFileSize()).toUtf8();
             RLogger::error("[%s] %s.\n",
                            this->settings.getName().toUtf8().constData(),
                            output.constData());
             R_LOG_TRACE_RETURN(RError::InvalidInput);
         }
+        paths.append(path);
+        totalContentSize += entry.size;
+        maxContentSize = qMax(maxContentSize,entry.size);
+    }
+
+    // Quota and store size are checked once for all members.
+    FileIndex::Usage userUsage = this->findUserUsage(executor.getName());
+    RFileQuota userStoreQuota(userUsage.size+totalContentSize,
+                              maxContentSize,
+                              userUsage.count+entries.size());
+
+    if (executor.getFileQuota().quotaExceeded(userStoreQuota))
+    {
+        output = QString("User file quota exceeded.").toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
     if (this->settings.getMaxStoreSize() > 0)
     {
-        if (object.getContent().size() + this->totalSize > this->settings.getMaxStoreSize())
+        if (totalContentSize + this->findStoreSize() > this->settings.getMaxStoreSize())
         {
-            output = QString("Invalid file size \"%1 bytes\". File store is full.").arg(object.getContent().size()).toUtf8();
+            output = QString("Invalid archive content size \"%1 bytes\". File store is full.").arg(totalContentSize).toUtf8();
             RLogger::error("[%s] %s.\n",
                            this->settings.getName().toUtf8().constData(),
                            output.constData());
@@ -429,125 +2542,501 @@ RError::Type FileManager::storeFile(const RUserInfo &executor, const FileObject
         }
     }
 
-    if (!RFileInfo::isPathValid(object.getInfo().getPath()))
+    // Members are written straight from the archive without copying their content.
+    QList<QUuid> storedIds;
+    QByteArray storedOutput;
+    FileListWriter writer(storedOutput);
+    for (qsizetype i=0;i<entries.size();i++)
     {
-        output = QString("Invalid path \"%1\"").arg(object.getInfo().getPath()).toUtf8();
+        const FileArchive::Entry &entry = entries.at(i);
+
+        FileObject memberObject;
+        memberObject.setInfo(object.getInfo());
+        memberObject.getInfo().setId(QUuid::createUuid());
+        memberObject.getInfo().setPath(paths.at(i));
+        memberObject.setContent(QByteArray::fromRawData(archive.constData() + entry.offset,entry.size));
+
+        RFileInfo fileInfo(memberObject.getInfo());
+        FileStorage fileStorage;
+
+        if (!this->writeFileContent(fileInfo,fileStorage,memberObject))
+        {
+            // Members stored so far are removed so that archive is stored either whole or not at all.
+            for (const QUuid &storedId : std::as_const(storedIds))
+            {
+                QByteArray removeOutput;
+                this->removeFile(executor,storedId,removeOutput);
+            }
+            output = QString("Failed to write archive member \"%1\"").arg(entry.name).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::WriteFile);
+        }
+
+        this->fileIndex.registerObject(fileInfo);
+        this->fileIndex.registerObjectStorage(fileInfo.getId(),fileStorage);
+        storedIds.append(fileInfo.getId());
+
+        this->totalSize += fileInfo.getSize();
+        this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeStore,double(fileInfo.getSize()));
+
+        writer.appendJson(this->fileIndex.getObjectJson(fileInfo));
+    }
+    writer.finish();
+
+    output = storedOutput;
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::fileMd5Checksum(const RUserInfo &executor, FileObject &object, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+    const QUuid id = object.getInfo().getId();
+
+    RLogger::debug("[%s] fileMd5Checksum: executor=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData());
+
+    if (!this->fileIndex.objectExists(id))
+    {
+        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    RFileInfo fileInfo(object.getInfo());
+    FileStorage fileStorage = this->fileIndex.getObjectStorage(id);
+    object.setInfo(this->fileIndex.getObjectInfo(id));
+    object.setCodec(fileStorage.codec);
+    object.setContentChecksum(FileChecksum::findContentChecksum(object.getInfo(),fileStorage));
 
-    if (!RFileTools::writeBinaryFile(this->findFilePath(fileInfo),object.getContent()))
+    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Read))
     {
-        output = QString("Failed to write file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),id.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
-        R_LOG_TRACE_RETURN(RError::WriteFile);
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
     }
 
-    fileInfo.setSize(QFileInfo(this->findFilePath(fileInfo)).size());
-    fileInfo.setMd5Checksum(RFileInfo::findMd5Checksum(this->findFilePath(fileInfo)));
+    // Missing checksum is computed by fileContentMd5Checksum() once index lock is released.
+    if (!object.getInfo().getMd5Checksum().isEmpty())
+    {
+        output = this->fileIndex.getObjectJson(object.getInfo());
+    }
 
-    this->fileIndex.registerObject(fileInfo);
+    R_LOG_TRACE_RETURN(RError::None);
+}
 
-    this->totalSize += fileInfo.getSize();
-    this->statistics.recordValue(FileManagerStatistics::Type::FileSizeStore,double(fileInfo.getSize()));
+RError::Type FileManager::fileContentMd5Checksum(FileObject &object, QByteArray &output) const
+{
+    R_LOG_TRACE_IN;
+    const QUuid id = object.getInfo().getId();
 
-    output = QJsonDocument(fileInfo.toJson()).toJson();
+    QString md5Checksum;
+    if (!this->computeMd5Checksum(this->findFilePath(object.getInfo(),object.getCodec()),object.getCodec(),md5Checksum))
+    {
+        output = QString("Failed to read file id=\"%1\"").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::ReadFile);
+    }
+
+    RFileInfo fileInfo = object.getInfo();
+    fileInfo.setMd5Checksum(md5Checksum);
+    object.setInfo(fileInfo);
 
     R_LOG_TRACE_RETURN(RError::None);
 }
 
-RError::Type FileManager::replaceFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+RError::Type FileManager::storeMd5Checksum(const FileObject &object, QByteArray &output)
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] replaceFile: executor=\"%s\", storePath=\"%s\".\n",
+    const QUuid &id = object.getInfo().getId();
+
+    if (!this->fileIndex.objectExists(id))
+    {
+        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    // Content may have been replaced while its checksum was computed.
+    RFileInfo fileInfo = this->fileIndex.getObjectInfo(id);
+    if (fileInfo.getMd5Checksum().isEmpty() &&
+        FileChecksum::findContentChecksum(fileInfo,this->fileIndex.getObjectStorage(id)) == object.getContentChecksum())
+    {
+        fileInfo.setMd5Checksum(object.getInfo().getMd5Checksum());
+        this->fileIndex.registerObject(fileInfo);
+    }
+
+    output = this->fileIndex.getObjectJson(fileInfo);
+
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+bool FileManager::computeMd5Checksum(const QString &fileName, const QString &codec, QString &md5Checksum) const
+{
+    R_LOG_TRACE_IN;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        RLogger::error("[%s] Failed to open file \"%s\" for reading. %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       file.fileName().toUtf8().constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    FileChecksum checksum(FileChecksum::md5);
+    bool readFailed = false;
+    if (codec.isEmpty())
+    {
+        QByteArray buffer(qMax(this->settings.getReadBufferSize(),qint64(4096)),Qt::Uninitialized);
+        qint64 nBytes = 0;
+        while ((nBytes = file.read(buffer.data(),buffer.size())) > 0)
+        {
+            checksum.addData(QByteArrayView(buffer.constData(),nBytes));
+        }
+        readFailed = (nBytes < 0);
+    }
+    else
+    {
+        readFailed = !FileCodec::decodeFrames(file,[&](QByteArrayView data)
+        {
+            checksum.addData(data);
+            return true;
+        });
+    }
+
+    if (readFailed)
+    {
+        RLogger::error("[%s] Failed to read file \"%s\". %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       file.fileName().toUtf8().constData(),
+                       file.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    md5Checksum = checksum.result();
+    R_LOG_TRACE_RETURN(true);
+}
+
+RError::Type FileManager::removeFile(const RUserInfo &executor, const QUuid &id, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] removeFile: executor=\"%s\", storePath=\"%s\".\n",
                    this->settings.getName().toUtf8().constData(),
                    executor.getName().toUtf8().constData(),
                    this->storePath.toUtf8().constData());
 
-    // List all files owned by executor.
-    QList<RFileInfo> files = this->fileIndex.listUserObjects(
-        [=](const RFileInfo &fileInfo)
+    if (!this->fileIndex.objectExists(id))
+    {
+        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+
+    RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+    FileStorage fileStorage(this->fileIndex.getObjectStorage(id));
+
+    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    {
+        output = QString("User \"%1\" is not authorized to remove file id=\"%2\"").arg(executor.getName(),fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::Unauthorized);
+    }
+    fileInfo = this->fileIndex.unregisterObject(id);
+    this->contentCache.remove(fileInfo.getId(),FileChecksum::findContentChecksum(fileInfo,fileStorage));
+
+    if (!this->releaseFileContent(fileInfo,fileStorage))
+    {
+        output = QString("Failed to remove file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::WriteFile);
+    }
+
+    this->totalSize -= fileInfo.getSize();
+    this->recordStatisticsValue(FileManagerStatistics::Type::FileSizeRemove,double(fileInfo.getSize()));
+
+    output = QJsonDocument(fileInfo.toJson()).toJson();
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+RError::Type FileManager::batchFiles(const RUserInfo &executor, FileManagerTask::Action action, const FileObject &object, QByteArray &output)
+{
+    R_LOG_TRACE_IN;
+    RLogger::debug("[%s] batchFiles: executor=\"%s\", action=\"%s\".\n",
+                   this->settings.getName().toUtf8().constData(),
+                   executor.getName().toUtf8().constData(),
+                   FileManagerTask::actionToString(action).toUtf8().constData());
+
+    QJsonParseError parseError;
+    QJsonDocument requestDocument = QJsonDocument::fromJson(object.getContent(),&parseError);
+    if (parseError.error != QJsonParseError::NoError || !requestDocument.isObject())
+    {
+        output = QString("Invalid batch request \"%1\"").arg(parseError.errorString()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
+    QJsonObject request = requestDocument.object();
+
+    QList<QUuid> ids;
+    const QJsonArray jIds = request["ids"].toArray();
+    for (const QJsonValue &jId : jIds)
+    {
+        QUuid id = QUuid::fromString(jId.toString());
+        if (id.isNull())
+        {
+            output = QString("Invalid file id \"%1\"").arg(jId.toString()).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        ids.append(id);
+    }
+
+    // Same change is applied to every file in the batch.
+    FileObject itemObject;
+    if (action == FileManagerTask::BatchUpdateFileAccessMode)
+    {
+        RAccessRights accessRights;
+        accessRights.setMode(RAccessMode::fromJson(request["mode"].toObject()));
+        itemObject.getInfo().setAccessRights(accessRights);
+    }
+    else if (action == FileManagerTask::BatchUpdateFileVersion)
+    {
+        itemObject.getInfo().setVersion(RVersion(request["version"].toString()));
+    }
+    else if (action == FileManagerTask::BatchUpdateFileTags)
+    {
+        QStringList tags;
+        const QJsonArray jTags = request["tags"].toArray();
+        for (const QJsonValue &jTag : jTags)
+        {
+            tags.append(jTag.toString());
+        }
+        itemObject.getInfo().setTags(tags);
+    }
+
+    // Each file is authorized separately, failure of one file does not stop the batch.
+    QJsonArray jResults;
+    for (const QUuid &id : std::as_const(ids))
+    {
+        QByteArray itemOutput;
+        RError::Type itemErrorType = RError::None;
+        if (action == FileManagerTask::BatchRemoveFiles)
+        {
+            itemErrorType = this->removeFile(executor,id,itemOutput);
+        }
+        else
         {
+            itemObject.getInfo().setId(id);
+            if (action == FileManagerTask::BatchUpdateFileAccessMode)
+            {
+                itemErrorType = this->updateFileAccessMode(executor,itemObject,itemOutput);
+            }
+            else if (action == FileManagerTask::BatchUpdateFileVersion)
+            {
+                itemErrorType = this->updateFileVersion(executor,itemObject,itemOutput);
+            }
+            else
+            {
+                itemErrorType = this->updateFileTags(executor,itemObject,itemOutput);
+            }
+        }
 
-            return (fileInfo.getPath() == object.getInfo().getPath() && // File paths must be equal.
-                    executor.isUser(fileInfo.getAccessRights().getOwner().getUser()) && // File must be owned by the executor.
-                    UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write)); // File must be writable.
+        QJsonObject jResult;
+        jResult["id"] = id.toString(QUuid::WithoutBraces);
+        if (itemErrorType == RError::None)
+        {
+            jResult["file"] = QJsonDocument::fromJson(itemOutput).object();
         }
-    );
+        else
+        {
+            jResult["error"] = QString::fromUtf8(itemOutput);
+        }
+        jResults.append(jResult);
+    }
 
-    QJsonObject jsonOutput;
-    QJsonArray jsonRemoveFileArray;
+    QJsonObject jOutput;
+    jOutput["results"] = jResults;
+    output = QJsonDocument(jOutput).toJson(QJsonDocument::Compact);
 
-    // Store new file object.
-    QByteArray uploadFileOutput;
-    RError::Type errorType = this->storeFile(executor,object,uploadFileOutput);
-    if (errorType != RError::None)
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+void FileManager::loadUploadSessions()
+{
+    R_LOG_TRACE_IN;
+    QDir sessionDir(this->uploadSessionPath);
+    if (!sessionDir.exists())
     {
-        output = uploadFileOutput;
-        R_LOG_TRACE_RETURN(errorType);
+        R_LOG_TRACE_OUT;
+        return;
     }
 
-    if (!files.isEmpty())
+    const QStringList sessionDirNames = sessionDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &sessionDirName : sessionDirNames)
     {
-        // Remove all replaced files.
-        for (const RFileInfo &fileInfo : std::as_const(files))
+        // Unreadable, corrupted or truncated session cannot be resumed nor expired.
+        FileUploadSession session;
+        bool sessionValid = false;
+        QFile sessionFile(sessionDir.absoluteFilePath(sessionDirName + "/session.json"));
+        if (sessionFile.open(QIODevice::ReadOnly))
         {
-            QByteArray removeFileOutput;
-            errorType = this->removeFile(executor,fileInfo.getId(),removeFileOutput);
-            jsonRemoveFileArray.append(QJsonDocument::fromJson(removeFileOutput).object());
-            if (errorType != RError::None)
+            QJsonParseError parseError;
+            QJsonDocument sessionDocument = QJsonDocument::fromJson(sessionFile.readAll(),&parseError);
+            sessionFile.close();
+            if (parseError.error == QJsonParseError::NoError && sessionDocument.isObject())
             {
-                output = uploadFileOutput;
-                R_LOG_TRACE_RETURN(errorType);
+                session = FileUploadSession::fromJson(sessionDocument.object());
+                sessionValid = (!session.getId().isNull() &&
+                                session.getId().toString(QUuid::WithoutBraces) == sessionDirName &&
+                                session.getSize() >= 0 &&
+                                session.getChunkSize() > 0);
+            }
+        }
+        if (!sessionValid)
+        {
+            RLogger::warning("[%s] Removing invalid upload session \"%s\".\n",
+                             this->settings.getName().toUtf8().constData(),
+                             sessionDirName.toUtf8().constData());
+            QDir(sessionDir.absoluteFilePath(sessionDirName)).removeRecursively();
+            continue;
+        }
+
+        // Chunks are written atomically, existing chunk file means the chunk was received.
+        // Session activity is taken from the last received chunk.
+        session.setUpdateDateTime(qMax(session.getUpdateDateTime(),session.getCreationDateTime()));
+        for (qint64 index=0;index<session.getChunkCount();index++)
+        {
+            QFileInfo chunkFileInfo(this->findUploadChunkPath(session.getId(),index));
+            if (chunkFileInfo.size() == session.findChunkSize(index))
+            {
+                session.setChunkReceived(index);
+                session.setUpdateDateTime(qMax(session.getUpdateDateTime(),chunkFileInfo.lastModified().toSecsSinceEpoch()));
             }
         }
+
+        this->uploadSessions.insert(session.getId(),session);
     }
 
-    jsonOutput["upload"] = QJsonDocument::fromJson(uploadFileOutput).object();
-    jsonOutput["remove"] = jsonRemoveFileArray;
+    RLogger::info("[%s] Loaded %lld upload sessions.\n",
+                  this->settings.getName().toUtf8().constData(),
+                  qlonglong(this->uploadSessions.size()));
+    R_LOG_TRACE_OUT;
+}
 
-    output = QJsonDocument(jsonOutput).toJson();
+QString FileManager::findUploadSessionPath(const QUuid &sessionId) const
+{
+    return QDir(this->uploadSessionPath).absoluteFilePath(sessionId.toString(QUuid::WithoutBraces));
+}
 
-    R_LOG_TRACE_RETURN(errorType);
+QString FileManager::findUploadChunkPath(const QUuid &sessionId, qint64 index) const
+{
+    return QDir(this->findUploadSessionPath(sessionId)).absoluteFilePath(QString("%1.chunk").arg(index));
 }
 
-RError::Type FileManager::updateFile(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+RError::Type FileManager::openUploadSession(const RUserInfo &executor, const FileObject &object, QByteArray &output)
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] updateFile: executor=\"%s\", storePath=\"%s\".\n",
+    RLogger::debug("[%s] openUploadSession: executor=\"%s\".\n",
                    this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
+                   executor.getName().toUtf8().constData());
 
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    QJsonObject requestJson = QJsonDocument::fromJson(object.getContent()).object();
+
+    FileUploadSession session;
+    session.setId(QUuid::createUuid());
+    session.setUser(executor.getName());
+    session.setPath(object.getInfo().getPath());
+    session.setFileId(object.getInfo().getId());
+    // Sizes may be given as numbers or as strings.
+    auto readSize = [&requestJson](const QString &key) -> qint64
     {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        bool ok = true;
+        qint64 value = requestJson[key].isString() ? requestJson[key].toString().toLongLong(&ok) : requestJson[key].toInteger(-1);
+        return ok ? value : -1;
+    };
+    session.setSize(readSize("size"));
+    session.setChunkSize(readSize("chunkSize"));
+    session.setCreationDateTime(QDateTime::currentSecsSinceEpoch());
+    session.setUpdateDateTime(session.getCreationDateTime());
+
+    if (session.getSize() < 0 || session.getChunkSize() <= 0)
+    {
+        output = QString("Invalid upload session size \"%1\" or chunk size \"%2\"").arg(session.getSize()).arg(session.getChunkSize()).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+    if (this->settings.getMaxFileSize() > 0 && session.getSize() > this->settings.getMaxFileSize())
+    {
+        output = QString("Invalid file size \"%1 bytes\" (max: \"%2 bytes\")").arg(session.getSize()).arg(this->settings.getMaxFileSize()).toUtf8();
+        RLogger::error("[%s] %s.\n",
+                       this->settings.getName().toUtf8().constData(),
+                       output.constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
+    }
 
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    if (!session.getFileId().isNull())
     {
-        output = QString("User \"%1\" is not authorized to update file id=\"%2\"").arg(executor.getName(),fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        // Session will update existing file.
+        if (!this->fileIndex.objectExists(session.getFileId()))
+        {
+            output = QString("File object \"%1\" does not exist").arg(session.getFileId().toString(QUuid::WithoutBraces)).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::InvalidInput);
+        }
+        RFileInfo fileInfo(this->fileIndex.getObjectInfo(session.getFileId()));
+        if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+        {
+            output = QString("User \"%1\" is not authorized to update file id=\"%2\"").arg(executor.getName(),fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
+            RLogger::error("[%s] %s.\n",
+                           this->settings.getName().toUtf8().constData(),
+                           output.constData());
+            R_LOG_TRACE_RETURN(RError::Unauthorized);
+        }
+        if (session.getPath().isEmpty())
+        {
+            session.setPath(fileInfo.getPath());
+        }
+    }
+
+    if (!RFileInfo::isPathValid(session.getPath()))
+    {
+        output = QString("Invalid path \"%1\"").arg(session.getPath()).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    RFileQuota userStoreQuota(this->fileIndex.findStoreSize(executor.getName()) + object.getContent().size() - fileInfo.getSize(),
-                              object.getContent().size() - fileInfo.getSize(),
-                              this->fileIndex.findStoreCount(executor.getName()));
+    // Declared size is reserved against user quota and store size until the session is committed, aborted or expires.
+    FileIndex::Usage userUsage = this->findUserUsage(executor.getName());
+    RFileQuota userStoreQuota(userUsage.size + session.getSize(),
+                              session.getSize(),
+                              userUsage.count + (session.getFileId().isNull() ? 1 : 0));
 
     if (executor.getFileQuota().quotaExceeded(userStoreQuota))
     {
@@ -558,326 +3047,287 @@ RError::Type FileManager::updateFile(const RUserInfo &executor, const FileObject
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    if (!RFileInfo::isPathValid(object.getInfo().getPath()))
+    if (this->settings.getMaxStoreSize() > 0 && session.getSize() + this->findStoreSize() > this->settings.getMaxStoreSize())
     {
-        output = QString("Invalid path \"%1\"").arg(object.getInfo().getPath()).toUtf8();
+        output = QString("Invalid file size \"%1 bytes\". File store is full.").arg(session.getSize()).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    fileInfo.setPath(object.getInfo().getPath());
-    fileInfo.setUpdateDateTime(QDateTime::currentSecsSinceEpoch());
-
-    if (!RFileTools::writeBinaryFile(this->findFilePath(fileInfo),object.getContent()))
+    QString sessionPath = this->findUploadSessionPath(session.getId());
+    FileSaveFile sessionFile(QDir(sessionPath).absoluteFilePath("session.json"),this->settings.getDurability() != FileSync::Durability::None);
+    if (!QDir().mkpath(sessionPath) ||
+        !sessionFile.open() ||
+        sessionFile.write(QJsonDocument(session.toJson()).toJson()) < 0 ||
+        !sessionFile.commit())
     {
-        output = QString("Failed to write file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
+        output = QString("Failed to create upload session id=\"%1\"").arg(session.getId().toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s. %s.\n",
                        this->settings.getName().toUtf8().constData(),
-                       output.constData());
+                       output.constData(),
+                       sessionFile.errorString().toUtf8().constData());
+        QDir(sessionPath).removeRecursively();
         R_LOG_TRACE_RETURN(RError::WriteFile);
     }
 
-    qint64 oldSize = fileInfo.getSize();
-    fileInfo.setSize(QFileInfo(this->findFilePath(fileInfo)).size());
-    fileInfo.setMd5Checksum(RFileInfo::findMd5Checksum(this->findFilePath(fileInfo)));
-
-    this->fileIndex.registerObject(fileInfo);
-
-    this->totalSize += fileInfo.getSize() - oldSize;
-    this->statistics.recordValue(FileManagerStatistics::Type::FileSizeUpdate,double(fileInfo.getSize()));
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    this->uploadSessions.insert(session.getId(),session);
+    sessionLocker.unlock();
 
-    output = QJsonDocument(fileInfo.toJson()).toJson();
+    output = QJsonDocument(session.toJson(true)).toJson();
 
     R_LOG_TRACE_RETURN(RError::None);
 }
 
-RError::Type FileManager::updateFileAccessOwner(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+RError::Type FileManager::storeUploadChunk(const RUserInfo &executor, const FileObject &object, QByteArray &output)
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] updateFileAccessOwner: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
+    const QUuid &sessionId = object.getInfo().getId();
 
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    // Chunk index is passed as resource name.
+    bool indexOk = false;
+    qint64 index = object.getInfo().getPath().toLongLong(&indexOk);
+
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    auto iter = this->uploadSessions.constFind(sessionId);
+    if (iter == this->uploadSessions.cend() || iter.value().getUser() != executor.getName())
     {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        sessionLocker.unlock();
+        output = QString("Upload session \"%1\" does not exist").arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
+    qint64 chunkSize = indexOk ? iter.value().findChunkSize(index) : -1;
+    sessionLocker.unlock();
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
-
-    if (!object.getInfo().getAccessRights().getOwner().isValid())
+    if (chunkSize < 0 || object.getContent().size() != chunkSize)
     {
-        output = QString("Invalid access owner").toUtf8();
+        output = QString("Invalid chunk \"%1\" of size \"%2 bytes\" for upload session \"%3\"").arg(object.getInfo().getPath()).arg(object.getContent().size()).arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    RAccessRights accessRights = fileInfo.getAccessRights();
-    accessRights.setOwner(object.getInfo().getAccessRights().getOwner());
-    fileInfo.setAccessRights(accessRights);
-
-    if (!this->userManager->containsUser(fileInfo.getAccessRights().getOwner().getUser()))
+    // Chunk is staged on disk, chunks may arrive in any order and in parallel.
+    FileSaveFile chunkFile(this->findUploadChunkPath(sessionId,index),this->settings.getDurability() != FileSync::Durability::None);
+    if (!chunkFile.open() ||
+        chunkFile.write(object.getContent()) != object.getContent().size() ||
+        !chunkFile.commit())
     {
-        output = QString("Invalid access owner user \"%1\"").arg(fileInfo.getAccessRights().getOwner().getUser()).toUtf8();
-        RLogger::error("[%s] %s.\n",
+        output = QString("Failed to write chunk \"%1\" of upload session \"%2\"").arg(index).arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
+        RLogger::error("[%s] %s. %s.\n",
                        this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
+                       output.constData(),
+                       chunkFile.errorString().toUtf8().constData());
+        R_LOG_TRACE_RETURN(RError::WriteFile);
     }
 
-    if (!this->userManager->containsGroup(fileInfo.getAccessRights().getOwner().getGroup()))
+    // Session may have been committed, aborted or expired while the chunk was written.
+    sessionLocker.relock();
+    auto sessionIter = this->uploadSessions.find(sessionId);
+    if (sessionIter == this->uploadSessions.end())
     {
-        output = QString("Invalid access owner group \"%1\"").arg(fileInfo.getAccessRights().getOwner().getGroup()).toUtf8();
+        sessionLocker.unlock();
+        output = QString("Upload session \"%1\" does not exist").arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
-
-    this->fileIndex.registerObject(fileInfo);
-
-    output = QJsonDocument(fileInfo.toJson()).toJson();
+    sessionIter.value().setChunkReceived(index);
+    sessionIter.value().setUpdateDateTime(QDateTime::currentSecsSinceEpoch());
+    output = QJsonDocument(sessionIter.value().toJson(true)).toJson();
 
     R_LOG_TRACE_RETURN(RError::None);
 }
 
-RError::Type FileManager::updateFileAccessMode(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+RError::Type FileManager::uploadSessionStatus(const RUserInfo &executor, const QUuid &sessionId, QByteArray &output) const
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] updateFileAccessMode: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
-
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
-    {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
-    }
-
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
-
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::None))
-    {
-        output = QString("User \"%1\" is not authorized to change access mode of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
-    }
-
-    if (!object.getInfo().getAccessRights().getMode().isValid())
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    auto iter = this->uploadSessions.constFind(sessionId);
+    if (iter == this->uploadSessions.cend() || iter.value().getUser() != executor.getName())
     {
-        output = QString("Invalid access rights").toUtf8();
+        sessionLocker.unlock();
+        output = QString("Upload session \"%1\" does not exist").arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    RAccessRights accessRights = fileInfo.getAccessRights();
-    accessRights.setMode(object.getInfo().getAccessRights().getMode());
-    fileInfo.setAccessRights(accessRights);
-
-    this->fileIndex.registerObject(fileInfo);
-
-    output = QJsonDocument(fileInfo.toJson()).toJson();
+    output = QJsonDocument(iter.value().toJson(true)).toJson();
 
     R_LOG_TRACE_RETURN(RError::None);
 }
 
-RError::Type FileManager::updateFileVersion(const RUserInfo &executor, const FileObject &object, QByteArray &output)
+RError::Type FileManager::commitUploadSession(const RUserInfo &executor, const FileObject &object, QByteArray &output)
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] updateFileVersion: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
+    const QUuid &sessionId = object.getInfo().getId();
 
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    auto iter = this->uploadSessions.constFind(sessionId);
+    if (iter == this->uploadSessions.cend() || iter.value().getUser() != executor.getName())
     {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        sessionLocker.unlock();
+        output = QString("Upload session \"%1\" does not exist").arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
+    FileUploadSession session(iter.value());
+    sessionLocker.unlock();
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
-
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    if (!session.isComplete())
     {
-        output = QString("User \"%1\" is not authorized to change version of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
+        output = QJsonDocument(session.toJson(true)).toJson();
+        RLogger::error("[%s] Upload session \"%s\" is not complete.\n",
                        this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+                       sessionId.toString(QUuid::WithoutBraces).toUtf8().constData());
+        R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
 
-    fileInfo.setVersion(object.getInfo().getVersion());
-
-    this->fileIndex.registerObject(fileInfo);
-
-    output = QJsonDocument(fileInfo.toJson()).toJson();
-
-    R_LOG_TRACE_RETURN(RError::None);
-}
+    // Session is removed while it is committed so that its reservation is not counted by store quota checks.
+    sessionLocker.relock();
+    this->uploadSessions.remove(sessionId);
+    sessionLocker.unlock();
 
-RError::Type FileManager::updateFileTags(const RUserInfo &executor, const FileObject &object, QByteArray &output)
-{
-    R_LOG_TRACE_IN;
-    RLogger::debug("[%s] updateFileTags: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
+    // Staged chunks are handed to regular store or update.
+    FileObject fileObject;
+    fileObject.getInfo().setPath(session.getPath());
+    fileObject.getInfo().setAccessRights(object.getInfo().getAccessRights());
 
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    QStringList contentFiles;
+    for (qint64 index=0;index<session.getChunkCount();index++)
     {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
+        contentFiles.append(this->findUploadChunkPath(sessionId,index));
     }
+    fileObject.setContentFiles(contentFiles);
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
-
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    RError::Type errorType = RError::None;
+    if (session.getFileId().isNull())
     {
-        output = QString("User \"%1\" is not authorized to change tags of file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+        fileObject.getInfo().setId(QUuid::createUuid());
+        errorType = this->storeFile(executor,fileObject,output);
     }
-
-    const QStringList &tags = object.getInfo().getTags();
-
-    if (tags.size() > RFileInfo::MaxNumTags)
+    else
     {
-        output = QString("Invalid number of tags \"%1\" (max=\"%2\")").arg(QString::number(tags.size()),QString::number(RFileInfo::MaxNumTags)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
+        fileObject.getInfo().setId(session.getFileId());
+        errorType = this->updateFile(executor,fileObject,output);
     }
 
-    for (const QString &tag : tags)
+    if (errorType == RError::None)
     {
-        if (!RFileInfo::isTagValid(tag))
-        {
-            output = QString("Invalid tag \"%1\"").arg(tag).toUtf8();
-            RLogger::error("[%s] %s.\n",
-                           this->settings.getName().toUtf8().constData(),
-                           output.constData());
-            R_LOG_TRACE_RETURN(RError::InvalidInput);
-        }
+        QDir(this->findUploadSessionPath(sessionId)).removeRecursively();
+    }
+    else
+    {
+        // Failed session stays open so that the commit can be retried.
+        sessionLocker.relock();
+        this->uploadSessions.insert(sessionId,session);
+        sessionLocker.unlock();
     }
 
-    fileInfo.setTags(object.getInfo().getTags());
-
-    this->fileIndex.registerObject(fileInfo);
-
-    output = QJsonDocument(fileInfo.toJson()).toJson();
-
-    R_LOG_TRACE_RETURN(RError::None);
+    R_LOG_TRACE_RETURN(errorType);
 }
 
-RError::Type FileManager::retrieveFile(const RUserInfo &executor, FileObject &object, QByteArray &output)
+RError::Type FileManager::abortUploadSession(const RUserInfo &executor, const QUuid &sessionId, QByteArray &output)
 {
     R_LOG_TRACE_IN;
-    RLogger::debug("[%s] retrieveFile: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
-
-    if (!this->fileIndex.objectExists(object.getInfo().getId()))
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    auto iter = this->uploadSessions.find(sessionId);
+    if (iter == this->uploadSessions.end() || iter.value().getUser() != executor.getName())
     {
-        output = QString("File object \"%1\" does not exist").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
+        sessionLocker.unlock();
+        output = QString("Upload session \"%1\" does not exist").arg(sessionId.toString(QUuid::WithoutBraces)).toUtf8();
         RLogger::error("[%s] %s.\n",
                        this->settings.getName().toUtf8().constData(),
                        output.constData());
         R_LOG_TRACE_RETURN(RError::InvalidInput);
     }
+    output = QJsonDocument(iter.value().toJson()).toJson();
+    this->uploadSessions.erase(iter);
+    sessionLocker.unlock();
 
-    object.setInfo(this->fileIndex.getObjectInfo(object.getInfo().getId()));
+    QDir(this->findUploadSessionPath(sessionId)).removeRecursively();
 
-    if (!UserManager::authorizeUserAccess(executor,object.getInfo().getAccessRights(),RAccessMode::Read))
-    {
-        output = QString("User \"%1\" is not authorized to retrieve file id=\"%2\"").arg(executor.getName(),object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
-    }
+    RLogger::info("[%s] Upload session \"%s\" was aborted.\n",
+                  this->settings.getName().toUtf8().constData(),
+                  sessionId.toString(QUuid::WithoutBraces).toUtf8().constData());
 
-    if (!RFileTools::readBinaryFile(this->findFilePath(object.getInfo()),output))
+    R_LOG_TRACE_RETURN(RError::None);
+}
+
+FileIndex::Usage FileManager::findUploadReservation(const QString &user) const
+{
+    FileIndex::Usage reservation;
+    for (auto iter = this->uploadSessions.cbegin(); iter != this->uploadSessions.cend(); ++iter)
     {
-        output = QString("Failed to read file id=\"%1\"").arg(object.getInfo().getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::ReadFile);
+        if (user.isEmpty() || iter.value().getUser() == user)
+        {
+            reservation.size += iter.value().getSize();
+            // Session updating existing file does not add new file.
+            reservation.count += iter.value().getFileId().isNull() ? 1 : 0;
+        }
     }
-    this->statistics.recordValue(FileManagerStatistics::Type::FileSizeRetrieve,double(object.getInfo().getSize()));
+    return reservation;
+}
 
-    R_LOG_TRACE_RETURN(RError::None);
+FileIndex::Usage FileManager::findUserUsage(const QString &user) const
+{
+    FileIndex::Usage userUsage = this->fileIndex.findUserUsage(user);
+
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    FileIndex::Usage reservation = this->findUploadReservation(user);
+    userUsage.size += reservation.size;
+    userUsage.count += reservation.count;
+
+    return userUsage;
 }
 
-RError::Type FileManager::removeFile(const RUserInfo &executor, const QUuid &id, QByteArray &output)
+qint64 FileManager::findStoreSize() const
 {
-    R_LOG_TRACE_IN;
-    RLogger::debug("[%s] removeFile: executor=\"%s\", storePath=\"%s\".\n",
-                   this->settings.getName().toUtf8().constData(),
-                   executor.getName().toUtf8().constData(),
-                   this->storePath.toUtf8().constData());
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    return this->totalSize + this->findUploadReservation().size;
+}
 
-    if (!this->fileIndex.objectExists(id))
-    {
-        output = QString("File object \"%1\" does not exist").arg(id.toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::InvalidInput);
-    }
+void FileManager::expireUploadSessions()
+{
+    R_LOG_TRACE_IN;
+    this->uploadSessionExpiryTimer.restart();
 
-    RFileInfo fileInfo(this->fileIndex.getObjectInfo(id));
+    qint64 expiryDateTime = QDateTime::currentSecsSinceEpoch() - qint64(this->settings.getUploadSessionTimeout());
 
-    if (!UserManager::authorizeUserAccess(executor,fileInfo.getAccessRights(),RAccessMode::Write))
+    QList<QUuid> expiredSessionIds;
+    QMutexLocker sessionLocker(&this->uploadSessionMutex);
+    for (auto iter = this->uploadSessions.begin(); iter != this->uploadSessions.end();)
     {
-        output = QString("User \"%1\" is not authorized to remove file id=\"%2\"").arg(executor.getName(),fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::Unauthorized);
+        if (iter.value().getUpdateDateTime() < expiryDateTime)
+        {
+            expiredSessionIds.append(iter.key());
+            iter = this->uploadSessions.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
     }
-    fileInfo = this->fileIndex.unregisterObject(id);
+    sessionLocker.unlock();
 
-    QDir storeDir(this->storePath);
-    if (!storeDir.remove(fileInfo.getId().toString(QUuid::WithoutBraces)))
+    // Staged chunks are removed without holding the mutex.
+    for (const QUuid &sessionId : std::as_const(expiredSessionIds))
     {
-        output = QString("Failed to remove file id=\"%1\"").arg(fileInfo.getId().toString(QUuid::WithoutBraces)).toUtf8();
-        RLogger::error("[%s] %s.\n",
-                       this->settings.getName().toUtf8().constData(),
-                       output.constData());
-        R_LOG_TRACE_RETURN(RError::WriteFile);
+        QDir(this->findUploadSessionPath(sessionId)).removeRecursively();
+        RLogger::info("[%s] Upload session \"%s\" expired.\n",
+                      this->settings.getName().toUtf8().constData(),
+                      sessionId.toString(QUuid::WithoutBraces).toUtf8().constData());
     }
-
-    this->totalSize -= fileInfo.getSize();
-    this->statistics.recordValue(FileManagerStatistics::Type::FileSizeRemove,double(fileInfo.getSize()));
-
-    output = QJsonDocument(fileInfo.toJson()).toJson();
-    R_LOG_TRACE_RETURN(RError::None);
+    R_LOG_TRACE_OUT;
 }
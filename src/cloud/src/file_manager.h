@@ -3,25 +3,37 @@
 
 #include <QObject>
 #include <QMap>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QQueue>
 #include <QSharedPointer>
 #include <QUuid>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include <rbl_job.h>
 
+#include "file_content_cache.h"
 #include "file_index.h"
 #include "file_manager_settings.h"
 #include "file_manager_statistics.h"
 #include "file_manager_task.h"
 #include "file_object.h"
+#include "file_upload_session.h"
 #include "user_manager.h"
 
 class FileManager : public RJob
 {
     Q_OBJECT
 
+    public:
+
+        //! Maximum number of directory levels file store can be sharded into.
+        static const uint maxShardLevels;
+
     private:
 
         //! File manager settings.
@@ -36,18 +48,64 @@ class FileManager : public RJob
         bool stopFlag;
         //! File store path.
         QString storePath;
+        //! Content addressed blob directory (used when deduplicating).
+        QString blobPath;
+        //! Store layout file (records number of shard levels files are stored in).
+        QString layoutFileName;
         //! Index file.
         QString indexFileName;
+        //! Index journal file.
+        QString indexJournalFileName;
+        //! Index journal file which is being compacted into index file.
+        QString indexCompactionJournalFileName;
+        //! Number of records written to index journal since last compaction.
+        qsizetype indexJournalLength;
         //! Index map.
         FileIndex fileIndex;
+        //! Index lock (shared by read-only tasks, exclusive for modifying tasks).
+        mutable QReadWriteLock indexLock;
+        //! Pool of threads executing read-only tasks and tasks which do not access the index.
+        QThreadPool readerPool;
+        //! Pool executing index compaction and snapshot loading.
+        QThreadPool compactionPool;
+        //! Cache of recently read file contents.
+        FileContentCache contentCache;
+
+        //! Upload sessions directory.
+        QString uploadSessionPath;
+        //! Open upload sessions.
+        QMap<QUuid,FileUploadSession> uploadSessions;
+        //! Upload sessions mutex.
+        mutable QMutex uploadSessionMutex;
+        //! Time elapsed since upload sessions were last checked for expiry.
+        QElapsedTimer uploadSessionExpiryTimer;
 
         QQueue<FileManagerTask> tasks;
 
         QMutex syncMutex;
         QMutex serviceMutex;
+        //! Condition signaling that new task was enqueued or stop was requested.
+        QWaitCondition taskCondition;
+        //! Statistics mutex.
+        mutable QMutex statisticsMutex;
 
         //! Total file size in store.
         qint64 totalSize;
+        //! Total size of archives being assembled.
+        qint64 archiveSizeInProgress;
+        //! Archive size mutex (archives are assembled by concurrent readers).
+        QMutex archiveMutex;
+
+        //! Number of modifying tasks whose index modifications were not written to journal yet.
+        qsizetype nUnflushedTasks;
+        //! Time elapsed since first modification was not written to journal.
+        QElapsedTimer journalFlushTimer;
+        //! Files and directories modified since they were last synced to disk (accessed by modifying tasks only).
+        QSet<QString> syncPaths;
+        //! Completed modifying tasks waiting for group sync.
+        QList<FileManagerTask> syncTasks;
+        //! Time elapsed since first task started waiting for group sync.
+        QElapsedTimer groupCommitTimer;
 
     public:
 
@@ -93,6 +151,42 @@ class FileManager : public RJob
         //! Request remove file.
         QUuid requestRemoveFile(const RUserInfo &executor, FileObject *object);
 
+        //! Request open upload session.
+        QUuid requestOpenUploadSession(const RUserInfo &executor, FileObject *object);
+
+        //! Request store upload session chunk.
+        QUuid requestStoreUploadChunk(const RUserInfo &executor, FileObject *object);
+
+        //! Request upload session status.
+        QUuid requestUploadSessionStatus(const RUserInfo &executor, FileObject *object);
+
+        //! Request commit upload session.
+        QUuid requestCommitUploadSession(const RUserInfo &executor, FileObject *object);
+
+        //! Request abort upload session.
+        QUuid requestAbortUploadSession(const RUserInfo &executor, FileObject *object);
+
+        //! Request remove multiple files.
+        QUuid requestBatchRemoveFiles(const RUserInfo &executor, FileObject *object);
+
+        //! Request update access mode of multiple files.
+        QUuid requestBatchUpdateFileAccessMode(const RUserInfo &executor, FileObject *object);
+
+        //! Request update version of multiple files.
+        QUuid requestBatchUpdateFileVersion(const RUserInfo &executor, FileObject *object);
+
+        //! Request update tags of multiple files.
+        QUuid requestBatchUpdateFileTags(const RUserInfo &executor, FileObject *object);
+
+        //! Request retrieve multiple files as tar archive.
+        QUuid requestRetrieveArchive(const RUserInfo &executor, FileObject *object);
+
+        //! Request store members of tar archive as files.
+        QUuid requestStoreArchive(const RUserInfo &executor, FileObject *object);
+
+        //! Request file information with MD5 checksum (computed if it is not known yet).
+        QUuid requestFileMd5Checksum(const RUserInfo &executor, FileObject *object);
+
         //! Get statistics output in Json form.
         QJsonObject getStatisticsJson() const;
 
@@ -102,6 +196,19 @@ class FileManager : public RJob
         //! Return const reference to file index.
         const FileIndex &getFileIndex() const;
 
+        //! Find up to given number of objects following given object ID in ID order (from the first if ID is null).
+        //! Returned objects have codec of their stored content set.
+        QList<FileObject> findStoredObjects(const QUuid &after, qsizetype count) const;
+
+        //! Return absolute path to stored content of given object.
+        QString findStoredFilePath(const FileObject &object) const;
+
+        //! Check if given object is still stored with the same content and codec.
+        bool isStoredObjectCurrent(const FileObject &object) const;
+
+        //! Find content files in store which are not referenced by any object.
+        QStringList findOrphanFiles() const;
+
     private:
 
         //! Initialize the store.
@@ -110,14 +217,69 @@ class FileManager : public RJob
         //! Enqueue task.
         QUuid enqueueTask(const FileManagerTask &task);
 
-        //! Build absolute path to file in store.
-        QString findFilePath(const RFileInfo &fileInfo) const;
+        //! Process single task.
+        void processTask(FileManagerTask &task);
+
+        //! Complete task which failed with exception.
+        void completeFailedTask(FileManagerTask &task, const QString &message);
+
+        //! Write pending index modifications to journal.
+        void flushJournal();
+
+        //! Find time in milliseconds until pending journal flush, group commit or upload session expiry is due (-1 if nothing is pending).
+        qint64 findFlushDelay() const;
+
+        //! Flush journal, commit group and expire upload sessions if they are due.
+        void flushDue();
+
+        //! Find time in milliseconds until upload sessions should be checked for expiry (-1 if there is nothing to expire).
+        qint64 findUploadSessionExpiryDelay() const;
+
+        //! Remember file or directory to be synced to disk (ignored if durability is none).
+        void addSyncPath(const QString &path);
+
+        //! Sync modified files and directories to disk.
+        //! Return false if any of them failed to sync.
+        bool syncModifiedPaths();
+
+        //! Sync tasks waiting for group sync and signal their completion.
+        void commitGroup();
+
+        //! Compact index journal into index file in background.
+        void compactIndex();
+
+        //! Load index snapshot into memory in background.
+        void materializeIndex();
+
+        //! Record statistics value.
+        void recordStatisticsValue(const QString &key, double value);
+
+        //! Record statistics counter.
+        void recordStatisticsCounter(const QString &key, qsizetype counter);
+
+        //! Build absolute path to file content stored with given codec.
+        QString findFilePath(const RFileInfo &fileInfo, const QString &codec) const;
+
+        //! Build absolute path to file with given name in directory sharded into given number of levels.
+        static QString findShardedFilePath(const QString &dirPath, const QString &fileName, uint shardLevels);
+
+        //! Find absolute paths of all files in directory sharded into given number of levels.
+        static QStringList findShardedFiles(const QString &dirPath, uint shardLevels);
+
+        //! Move file contents between flat and sharded layout to match settings.
+        void migrateFileLayout();
+
+        //! Move file contents between per-object and content addressed layout to match settings.
+        void migrateFileStore();
+
+        //! Remove file content unless it is still referenced by other objects.
+        bool releaseFileContent(const RFileInfo &fileInfo, const FileStorage &fileStorage);
 
         //! List files.
-        RError::Type listFiles(const RUserInfo &executor, QByteArray &output) const;
+        RError::Type listFiles(const RUserInfo &executor, const FileObject &object, QByteArray &output) const;
 
         //! Detailed file information.
-        RError::Type fileInfo(const RUserInfo &executor, const QUuid &id, QByteArray &output) const;
+        RError::Type fileInfo(const RUserInfo &executor, FileObject &object, QByteArray &output) const;
 
         //! Store file.
         RError::Type storeFile(const RUserInfo &executor, const FileObject &object, QByteArray &output);
@@ -143,9 +305,91 @@ class FileManager : public RJob
         //! Retrieve file.
         RError::Type retrieveFile(const RUserInfo &executor, FileObject &object, QByteArray &output);
 
+        //! Evaluate conditions of given request on file with given content checksum.
+        //! If file was not modified notModified is set and output is set to not-modified response.
+        RError::Type evaluateCondition(const RFileInfo &fileInfo, const QString &contentChecksum, const QByteArray &request, bool &notModified, QByteArray &output) const;
+
+        //! Find size of object content.
+        static qint64 findContentSize(const FileObject &object);
+
+        //! Write object content to file and update file size, checksum and stored form.
+        bool writeFileContent(RFileInfo &fileInfo, FileStorage &fileStorage, const FileObject &object);
+
+        //! Read content (or requested range) of retrieved file.
+        RError::Type readFileContent(const FileObject &object, QByteArray &output);
+
+        //! Read given length of stored content starting at given offset into data.
+        //! Raw content is read from current file position.
+        bool readStoredContent(QFile &file, bool compressed, qint64 offset, qint64 length, char *data) const;
+
+        //! Select files of archive request the executor is authorized to read.
+        RError::Type retrieveArchive(const RUserInfo &executor, const FileObject &object, QList<FileObject> &archiveObjects, QByteArray &output) const;
+
+        //! Read tar archive of selected files.
+        RError::Type readArchiveContent(const QList<FileObject> &archiveObjects, QByteArray &output);
+
+        //! Assemble archive of given size from contents of given objects in memory.
+        RError::Type assembleArchive(const QList<FileObject> &archiveObjects, qint64 archiveSize, QByteArray &output);
+
+        //! Store members of tar archive as files under path prefix.
+        RError::Type storeArchive(const RUserInfo &executor, const FileObject &object, QByteArray &output);
+
+        //! File information with MD5 checksum.
+        //! Output is left empty if MD5 checksum has to be computed by fileContentMd5Checksum().
+        RError::Type fileMd5Checksum(const RUserInfo &executor, FileObject &object, QByteArray &output) const;
+
+        //! Compute MD5 checksum of stored content of given file and set it to object file information.
+        RError::Type fileContentMd5Checksum(FileObject &object, QByteArray &output) const;
+
+        //! Register MD5 checksum computed by fileContentMd5Checksum() in index.
+        RError::Type storeMd5Checksum(const FileObject &object, QByteArray &output);
+
+        //! Compute MD5 checksum of content stored in given file with given codec.
+        bool computeMd5Checksum(const QString &fileName, const QString &codec, QString &md5Checksum) const;
+
         //! Remove file.
         RError::Type removeFile(const RUserInfo &executor, const QUuid &id, QByteArray &output);
 
+        //! Apply remove or update action to each file of the batch and output per-file results.
+        RError::Type batchFiles(const RUserInfo &executor, FileManagerTask::Action action, const FileObject &object, QByteArray &output);
+
+        //! Load upload sessions left from previous run.
+        void loadUploadSessions();
+
+        //! Build absolute path to upload session directory.
+        QString findUploadSessionPath(const QUuid &sessionId) const;
+
+        //! Build absolute path to upload session chunk file.
+        QString findUploadChunkPath(const QUuid &sessionId, qint64 index) const;
+
+        //! Open upload session.
+        RError::Type openUploadSession(const RUserInfo &executor, const FileObject &object, QByteArray &output);
+
+        //! Store upload session chunk.
+        RError::Type storeUploadChunk(const RUserInfo &executor, const FileObject &object, QByteArray &output);
+
+        //! Upload session status.
+        RError::Type uploadSessionStatus(const RUserInfo &executor, const QUuid &sessionId, QByteArray &output) const;
+
+        //! Commit upload session.
+        RError::Type commitUploadSession(const RUserInfo &executor, const FileObject &object, QByteArray &output);
+
+        //! Abort upload session.
+        RError::Type abortUploadSession(const RUserInfo &executor, const QUuid &sessionId, QByteArray &output);
+
+        //! Find store usage of given user including size and number of files reserved by open upload sessions.
+        FileIndex::Usage findUserUsage(const QString &user) const;
+
+        //! Find total file size in store including size reserved by open upload sessions.
+        qint64 findStoreSize() const;
+
+        //! Find size and number of files reserved by open upload sessions of given user (all sessions if user is empty).
+        //! Upload sessions mutex must be held.
+        FileIndex::Usage findUploadReservation(const QString &user = QString()) const;
+
+        //! Remove upload sessions idle for longer than configured timeout.
+        void expireUploadSessions();
+
     signals:
 
         //! Service is ready.
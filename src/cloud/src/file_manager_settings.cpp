@@ -1,4 +1,5 @@
 #include "file_manager_settings.h"
+#include "file_sync.h"
 
 void FileManagerSettings::_init(const FileManagerSettings *pFileManagerSettings)
 {
@@ -8,12 +9,51 @@ void FileManagerSettings::_init(const FileManagerSettings *pFileManagerSettings)
         this->fileStore = pFileManagerSettings->fileStore;
         this->maxStoreSize = pFileManagerSettings->maxStoreSize;
         this->maxFileSize = pFileManagerSettings->maxFileSize;
+        this->readerCount = pFileManagerSettings->readerCount;
+        this->journalLimit = pFileManagerSettings->journalLimit;
+        this->readBufferSize = pFileManagerSettings->readBufferSize;
+        this->writeBufferSize = pFileManagerSettings->writeBufferSize;
+        this->deduplicate = pFileManagerSettings->deduplicate;
+        this->compression = pFileManagerSettings->compression;
+        this->cacheSize = pFileManagerSettings->cacheSize;
+        this->cacheMaxFileSize = pFileManagerSettings->cacheMaxFileSize;
+        this->shardLevels = pFileManagerSettings->shardLevels;
+        this->durability = pFileManagerSettings->durability;
+        this->groupCommitWindow = pFileManagerSettings->groupCommitWindow;
+        this->journalFlushInterval = pFileManagerSettings->journalFlushInterval;
+        this->journalFlushCount = pFileManagerSettings->journalFlushCount;
+        this->archiveMaxSize = pFileManagerSettings->archiveMaxSize;
+        this->scrubBandwidth = pFileManagerSettings->scrubBandwidth;
+        this->scrubInterval = pFileManagerSettings->scrubInterval;
+        this->checksum = pFileManagerSettings->checksum;
+        this->retrieveMaxSize = pFileManagerSettings->retrieveMaxSize;
+        this->uploadSessionTimeout = pFileManagerSettings->uploadSessionTimeout;
+        this->archiveMemoryLimit = pFileManagerSettings->archiveMemoryLimit;
     }
 }
 
 FileManagerSettings::FileManagerSettings()
     : maxStoreSize(-1)
     , maxFileSize(-1)
+    , readerCount(0)
+    , journalLimit(10000)
+    , readBufferSize(1048576)
+    , writeBufferSize(1048576)
+    , deduplicate(false)
+    , cacheSize(67108864)
+    , cacheMaxFileSize(1048576)
+    , shardLevels(0)
+    , durability(FileSync::Durability::None)
+    , groupCommitWindow(10)
+    , journalFlushInterval(100)
+    , journalFlushCount(1000)
+    , archiveMaxSize(33554432)
+    , scrubBandwidth(1048576)
+    , scrubInterval(86400)
+    , checksum(QString("xxh64"))
+    , retrieveMaxSize(0)
+    , uploadSessionTimeout(86400)
+    , archiveMemoryLimit(268435456)
 {
     this->_init();
     this->name = "FileService";
@@ -60,3 +100,203 @@ void FileManagerSettings::setMaxFileSize(qint64 maxFileSize)
 {
     this->maxFileSize = maxFileSize;
 }
+
+uint FileManagerSettings::getReaderCount() const
+{
+    return this->readerCount;
+}
+
+void FileManagerSettings::setReaderCount(uint readerCount)
+{
+    this->readerCount = readerCount;
+}
+
+qint64 FileManagerSettings::getJournalLimit() const
+{
+    return this->journalLimit;
+}
+
+void FileManagerSettings::setJournalLimit(qint64 journalLimit)
+{
+    this->journalLimit = journalLimit;
+}
+
+qint64 FileManagerSettings::getReadBufferSize() const
+{
+    return this->readBufferSize;
+}
+
+void FileManagerSettings::setReadBufferSize(qint64 readBufferSize)
+{
+    this->readBufferSize = readBufferSize;
+}
+
+qint64 FileManagerSettings::getWriteBufferSize() const
+{
+    return this->writeBufferSize;
+}
+
+void FileManagerSettings::setWriteBufferSize(qint64 writeBufferSize)
+{
+    this->writeBufferSize = writeBufferSize;
+}
+
+bool FileManagerSettings::getDeduplicate() const
+{
+    return this->deduplicate;
+}
+
+void FileManagerSettings::setDeduplicate(bool deduplicate)
+{
+    this->deduplicate = deduplicate;
+}
+
+const QString &FileManagerSettings::getCompression() const
+{
+    return this->compression;
+}
+
+void FileManagerSettings::setCompression(const QString &compression)
+{
+    this->compression = compression;
+}
+
+qint64 FileManagerSettings::getCacheSize() const
+{
+    return this->cacheSize;
+}
+
+void FileManagerSettings::setCacheSize(qint64 cacheSize)
+{
+    this->cacheSize = cacheSize;
+}
+
+qint64 FileManagerSettings::getCacheMaxFileSize() const
+{
+    return this->cacheMaxFileSize;
+}
+
+void FileManagerSettings::setCacheMaxFileSize(qint64 cacheMaxFileSize)
+{
+    this->cacheMaxFileSize = cacheMaxFileSize;
+}
+
+uint FileManagerSettings::getShardLevels() const
+{
+    return this->shardLevels;
+}
+
+void FileManagerSettings::setShardLevels(uint shardLevels)
+{
+    this->shardLevels = shardLevels;
+}
+
+const QString &FileManagerSettings::getDurability() const
+{
+    return this->durability;
+}
+
+void FileManagerSettings::setDurability(const QString &durability)
+{
+    this->durability = durability;
+}
+
+uint FileManagerSettings::getGroupCommitWindow() const
+{
+    return this->groupCommitWindow;
+}
+
+void FileManagerSettings::setGroupCommitWindow(uint groupCommitWindow)
+{
+    this->groupCommitWindow = groupCommitWindow;
+}
+
+uint FileManagerSettings::getJournalFlushInterval() const
+{
+    return this->journalFlushInterval;
+}
+
+void FileManagerSettings::setJournalFlushInterval(uint journalFlushInterval)
+{
+    this->journalFlushInterval = journalFlushInterval;
+}
+
+uint FileManagerSettings::getJournalFlushCount() const
+{
+    return this->journalFlushCount;
+}
+
+void FileManagerSettings::setJournalFlushCount(uint journalFlushCount)
+{
+    this->journalFlushCount = journalFlushCount;
+}
+
+qint64 FileManagerSettings::getArchiveMaxSize() const
+{
+    return this->archiveMaxSize;
+}
+
+void FileManagerSettings::setArchiveMaxSize(qint64 archiveMaxSize)
+{
+    this->archiveMaxSize = archiveMaxSize;
+}
+
+qint64 FileManagerSettings::getScrubBandwidth() const
+{
+    return this->scrubBandwidth;
+}
+
+void FileManagerSettings::setScrubBandwidth(qint64 scrubBandwidth)
+{
+    this->scrubBandwidth = scrubBandwidth;
+}
+
+uint FileManagerSettings::getScrubInterval() const
+{
+    return this->scrubInterval;
+}
+
+void FileManagerSettings::setScrubInterval(uint scrubInterval)
+{
+    this->scrubInterval = scrubInterval;
+}
+
+const QString &FileManagerSettings::getChecksum() const
+{
+    return this->checksum;
+}
+
+void FileManagerSettings::setChecksum(const QString &checksum)
+{
+    this->checksum = checksum;
+}
+
+qint64 FileManagerSettings::getRetrieveMaxSize() const
+{
+    return this->retrieveMaxSize;
+}
+
+void FileManagerSettings::setRetrieveMaxSize(qint64 retrieveMaxSize)
+{
+    this->retrieveMaxSize = retrieveMaxSize;
+}
+
+uint FileManagerSettings::getUploadSessionTimeout() const
+{
+    return this->uploadSessionTimeout;
+}
+
+void FileManagerSettings::setUploadSessionTimeout(uint uploadSessionTimeout)
+{
+    this->uploadSessionTimeout = uploadSessionTimeout;
+}
+
+qint64 FileManagerSettings::getArchiveMemoryLimit() const
+{
+    return this->archiveMemoryLimit;
+}
+
+void FileManagerSettings::setArchiveMemoryLimit(qint64 archiveMemoryLimit)
+{
+    this->archiveMemoryLimit = archiveMemoryLimit;
+}
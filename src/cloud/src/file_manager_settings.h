@@ -21,6 +21,46 @@ class FileManagerSettings : public ServiceSettings
         qint64 maxStoreSize;
         //! Max file size.
         qint64 maxFileSize;
+        //! Number of reader threads (0 = ideal thread count).
+        uint readerCount;
+        //! Number of index journal records triggering index compaction (0 = never compact).
+        qint64 journalLimit;
+        //! Size of buffer used to read files.
+        qint64 readBufferSize;
+        //! Size of chunks written to files.
+        qint64 writeBufferSize;
+        //! Store identical file contents only once (content addressed blobs).
+        bool deduplicate;
+        //! Codec used to compress stored files (empty = no compression).
+        QString compression;
+        //! Size of in-memory cache of file contents (0 = no cache).
+        qint64 cacheSize;
+        //! Maximum size of file kept in in-memory cache.
+        qint64 cacheMaxFileSize;
+        //! Number of directory levels (two hexadecimal characters each) file store is sharded into.
+        uint shardLevels;
+        //! Durability of file store modifications (none, operation or group).
+        QString durability;
+        //! Time window (in milliseconds) of modifications synced to disk together (group durability).
+        uint groupCommitWindow;
+        //! Maximum time (in milliseconds) index modifications are kept before they are written to journal.
+        uint journalFlushInterval;
+        //! Maximum number of modifications kept before they are written to journal.
+        uint journalFlushCount;
+        //! Maximum size of archive assembled for multi-file download.
+        qint64 archiveMaxSize;
+        //! Bandwidth (bytes per second) of background integrity scrubbing (0 = disabled).
+        qint64 scrubBandwidth;
+        //! Interval in seconds between background integrity scrubbing passes.
+        uint scrubInterval;
+        //! Algorithm of checksum computed for stored files (md5, xxh64).
+        QString checksum;
+        //! Maximum size of content read by single file download (larger files must be downloaded by ranges).
+        qint64 retrieveMaxSize;
+        //! Time in seconds after which idle upload session expires (0 = never).
+        uint uploadSessionTimeout;
+        //! Total size of archives assembled for multi-file downloads at the same time.
+        qint64 archiveMemoryLimit;
 
     public:
 
@@ -54,6 +94,126 @@ class FileManagerSettings : public ServiceSettings
         //! Set maximum file size.
         void setMaxFileSize(qint64 maxFileSize);
 
+        //! Return number of reader threads.
+        uint getReaderCount() const;
+
+        //! Set number of reader threads.
+        void setReaderCount(uint readerCount);
+
+        //! Return number of index journal records triggering index compaction.
+        qint64 getJournalLimit() const;
+
+        //! Set number of index journal records triggering index compaction.
+        void setJournalLimit(qint64 journalLimit);
+
+        //! Return size of buffer used to read files.
+        qint64 getReadBufferSize() const;
+
+        //! Set size of buffer used to read files.
+        void setReadBufferSize(qint64 readBufferSize);
+
+        //! Return size of chunks written to files.
+        qint64 getWriteBufferSize() const;
+
+        //! Set size of chunks written to files.
+        void setWriteBufferSize(qint64 writeBufferSize);
+
+        //! Return whether identical file contents are stored only once.
+        bool getDeduplicate() const;
+
+        //! Set whether identical file contents are stored only once.
+        void setDeduplicate(bool deduplicate);
+
+        //! Return codec used to compress stored files.
+        const QString &getCompression() const;
+
+        //! Set codec used to compress stored files.
+        void setCompression(const QString &compression);
+
+        //! Return size of in-memory cache of file contents.
+        qint64 getCacheSize() const;
+
+        //! Set size of in-memory cache of file contents.
+        void setCacheSize(qint64 cacheSize);
+
+        //! Return maximum size of file kept in in-memory cache.
+        qint64 getCacheMaxFileSize() const;
+
+        //! Set maximum size of file kept in in-memory cache.
+        void setCacheMaxFileSize(qint64 cacheMaxFileSize);
+
+        //! Return number of directory levels file store is sharded into.
+        uint getShardLevels() const;
+
+        //! Set number of directory levels file store is sharded into.
+        void setShardLevels(uint shardLevels);
+
+        //! Return durability of file store modifications.
+        const QString &getDurability() const;
+
+        //! Set durability of file store modifications.
+        void setDurability(const QString &durability);
+
+        //! Return time window of modifications synced to disk together.
+        uint getGroupCommitWindow() const;
+
+        //! Set time window of modifications synced to disk together.
+        void setGroupCommitWindow(uint groupCommitWindow);
+
+        //! Return maximum time index modifications are kept before they are written to journal.
+        uint getJournalFlushInterval() const;
+
+        //! Set maximum time index modifications are kept before they are written to journal.
+        void setJournalFlushInterval(uint journalFlushInterval);
+
+        //! Return maximum number of modifications kept before they are written to journal.
+        uint getJournalFlushCount() const;
+
+        //! Set maximum number of modifications kept before they are written to journal.
+        void setJournalFlushCount(uint journalFlushCount);
+
+        //! Return maximum size of archive assembled for multi-file download.
+        qint64 getArchiveMaxSize() const;
+
+        //! Set maximum size of archive assembled for multi-file download.
+        void setArchiveMaxSize(qint64 archiveMaxSize);
+
+        //! Return bandwidth (bytes per second) of background integrity scrubbing (0 = disabled).
+        qint64 getScrubBandwidth() const;
+
+        //! Set bandwidth (bytes per second) of background integrity scrubbing (0 = disabled).
+        void setScrubBandwidth(qint64 scrubBandwidth);
+
+        //! Return interval in seconds between background integrity scrubbing passes.
+        uint getScrubInterval() const;
+
+        //! Set interval in seconds between background integrity scrubbing passes.
+        void setScrubInterval(uint scrubInterval);
+
+        //! Return algorithm of checksum computed for stored files.
+        const QString &getChecksum() const;
+
+        //! Set algorithm of checksum computed for stored files.
+        void setChecksum(const QString &checksum);
+
+        //! Return maximum size of content read by single file download (0 = unlimited).
+        qint64 getRetrieveMaxSize() const;
+
+        //! Set maximum size of content read by single file download.
+        void setRetrieveMaxSize(qint64 retrieveMaxSize);
+
+        //! Return time in seconds after which idle upload session expires.
+        uint getUploadSessionTimeout() const;
+
+        //! Set time in seconds after which idle upload session expires.
+        void setUploadSessionTimeout(uint uploadSessionTimeout);
+
+        //! Return total size of archives assembled for multi-file downloads at the same time.
+        qint64 getArchiveMemoryLimit() const;
+
+        //! Set total size of archives assembled for multi-file downloads at the same time.
+        void setArchiveMemoryLimit(qint64 archiveMemoryLimit);
+
 };
 
 #endif // FILE_MANAGER_SETTINGS_H
@@ -4,6 +4,14 @@ const QString FileManagerStatistics::Type::FileSizeStore = "file-size-store";
 const QString FileManagerStatistics::Type::FileSizeUpdate = "file-size-update";
 const QString FileManagerStatistics::Type::FileSizeRetrieve = "file-size-retrieve";
 const QString FileManagerStatistics::Type::FileSizeRemove = "file-size-remove";
+const QString FileManagerStatistics::Type::TaskQueueWait = "task-queue-wait";
+const QString FileManagerStatistics::Type::CacheHit = "cache-hit";
+const QString FileManagerStatistics::Type::CacheMiss = "cache-miss";
+const QString FileManagerStatistics::Type::CacheEviction = "cache-eviction";
+const QString FileManagerStatistics::Type::SyncDuration = "sync-duration";
+const QString FileManagerStatistics::Type::GroupCommitSize = "group-commit-size";
+const QString FileManagerStatistics::Type::JournalFlushDuration = "journal-flush-duration";
+const QString FileManagerStatistics::Type::JournalFlushSize = "journal-flush-size";
 
 void FileManagerStatistics::_init(const FileManagerStatistics *pFileManagerStatistics)
 {
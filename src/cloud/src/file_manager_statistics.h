@@ -16,6 +16,14 @@ class FileManagerStatistics : public ServiceStatistics
             static const QString FileSizeUpdate;
             static const QString FileSizeRetrieve;
             static const QString FileSizeRemove;
+            static const QString TaskQueueWait;
+            static const QString CacheHit;
+            static const QString CacheMiss;
+            static const QString CacheEviction;
+            static const QString SyncDuration;
+            static const QString GroupCommitSize;
+            static const QString JournalFlushDuration;
+            static const QString JournalFlushSize;
         };
 
     protected:
@@ -8,6 +8,7 @@ void FileManagerTask::_init(const FileManagerTask *pFileManagerTask)
         this->executor = pFileManagerTask->executor;
         this->action = pFileManagerTask->action;
         this->object = pFileManagerTask->object;
+        this->queueTimer = pFileManagerTask->queueTimer;
     }
 }
 
@@ -18,6 +19,7 @@ FileManagerTask::FileManagerTask(const RUserInfo &executor, Action action, FileO
     object(QSharedPointer<FileObject>(object))
 {
     this->_init();
+    this->queueTimer.start();
 }
 
 FileManagerTask::FileManagerTask(const FileManagerTask &fileManagerTask)
@@ -51,6 +53,11 @@ FileManagerTask::Action FileManagerTask::getAction() const
     return this->action;
 }
 
+void FileManagerTask::setAction(Action action)
+{
+    this->action = action;
+}
+
 const FileObject *FileManagerTask::getObject() const
 {
     return this->object.get();
@@ -66,6 +73,11 @@ const QSharedPointer<FileObject> &FileManagerTask::getObjectShared() const
     return this->object;
 }
 
+double FileManagerTask::getQueueWaitTime() const
+{
+    return double(this->queueTimer.nsecsElapsed()) / 1.0e6;
+}
+
 QString FileManagerTask::actionToString(const Action &action)
 {
     switch (action)
@@ -94,7 +106,48 @@ QString FileManagerTask::actionToString(const Action &action)
             return QString("Retrieve file");
         case RemoveFile:
             return QString("Remove file");
+        case OpenUploadSession:
+            return QString("Open upload session");
+        case StoreUploadChunk:
+            return QString("Store upload chunk");
+        case UploadSessionStatus:
+            return QString("Upload session status");
+        case CommitUploadSession:
+            return QString("Commit upload session");
+        case AbortUploadSession:
+            return QString("Abort upload session");
+        case BatchRemoveFiles:
+            return QString("Batch remove files");
+        case BatchUpdateFileAccessMode:
+            return QString("Batch update file access mode");
+        case BatchUpdateFileVersion:
+            return QString("Batch update file version");
+        case BatchUpdateFileTags:
+            return QString("Batch update file tags");
+        case RetrieveArchive:
+            return QString("Retrieve archive");
+        case StoreArchive:
+            return QString("Store archive");
+        case FileMd5Checksum:
+            return QString("File MD5 checksum");
+        case StoreMd5Checksum:
+            return QString("Store MD5 checksum");
         default:
             return QString("Unknown");
     }
 }
+
+bool FileManagerTask::isReadOnly(const Action &action)
+{
+    return (action == ListFiles ||
+            action == FileInfo ||
+            action == RetrieveFile ||
+            action == UploadSessionStatus ||
+            action == RetrieveArchive ||
+            action == FileMd5Checksum);
+}
+
+bool FileManagerTask::isIndexIndependent(const Action &action)
+{
+    return (action == StoreUploadChunk);
+}
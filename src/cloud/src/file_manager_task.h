@@ -1,6 +1,7 @@
 #ifndef FILE_MANAGER_TASK_H
 #define FILE_MANAGER_TASK_H
 
+#include <QElapsedTimer>
 #include <QSharedPointer>
 #include <QString>
 
@@ -32,6 +33,19 @@ class FileManagerTask
             UpdateFileTags,
             RetrieveFile,
             RemoveFile,
+            OpenUploadSession,
+            StoreUploadChunk,
+            UploadSessionStatus,
+            CommitUploadSession,
+            AbortUploadSession,
+            BatchRemoveFiles,
+            BatchUpdateFileAccessMode,
+            BatchUpdateFileVersion,
+            BatchUpdateFileTags,
+            RetrieveArchive,
+            StoreArchive,
+            FileMd5Checksum,
+            StoreMd5Checksum,
             NTypes
         };
 
@@ -41,6 +55,7 @@ class FileManagerTask
         RUserInfo executor;
         Action action;
         QSharedPointer<FileObject> object;
+        QElapsedTimer queueTimer;
 
     public:
 
@@ -65,6 +80,9 @@ class FileManagerTask
         //! Get action.
         Action getAction() const;
 
+        //! Set action.
+        void setAction(Action action);
+
         //! Get const pointer to object.
         const FileObject *getObject() const;
 
@@ -74,8 +92,17 @@ class FileManagerTask
         //! Get shared pointer to object.
         const QSharedPointer<FileObject> &getObjectShared() const;
 
+        //! Get time in milliseconds elapsed since the task was created.
+        double getQueueWaitTime() const;
+
         static QString actionToString(const FileManagerTask::Action &action);
 
+        //! Check if given action does not modify the file index nor store state (upload sessions and their reservations).
+        static bool isReadOnly(const FileManagerTask::Action &action);
+
+        //! Check if given action does not access the file index (runs concurrently without holding index lock).
+        static bool isIndexIndependent(const FileManagerTask::Action &action);
+
 };
 
 #endif // FILE_MANAGER_TASK_H
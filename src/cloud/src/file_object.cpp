@@ -6,12 +6,17 @@ void FileObject::_init(const FileObject *pFileObject)
     {
         this->info = pFileObject->info;
         this->content = pFileObject->content;
+        this->contentFiles = pFileObject->contentFiles;
+        this->codec = pFileObject->codec;
+        this->contentChecksum = pFileObject->contentChecksum;
         this->errorType = pFileObject->errorType;
+        this->notModified = pFileObject->notModified;
     }
 }
 
 FileObject::FileObject()
     : errorType(RError::None)
+    , notModified(false)
 {
     this->_init();
 }
@@ -56,6 +61,36 @@ void FileObject::setContent(const QByteArray &content)
     this->content = content;
 }
 
+const QStringList &FileObject::getContentFiles() const
+{
+    return this->contentFiles;
+}
+
+void FileObject::setContentFiles(const QStringList &contentFiles)
+{
+    this->contentFiles = contentFiles;
+}
+
+const QString &FileObject::getCodec() const
+{
+    return this->codec;
+}
+
+void FileObject::setCodec(const QString &codec)
+{
+    this->codec = codec;
+}
+
+const QString &FileObject::getContentChecksum() const
+{
+    return this->contentChecksum;
+}
+
+void FileObject::setContentChecksum(const QString &contentChecksum)
+{
+    this->contentChecksum = contentChecksum;
+}
+
 RError::Type FileObject::getErrorType() const
 {
     return this->errorType;
@@ -65,3 +100,13 @@ void FileObject::setErrorType(RError::Type errorType)
 {
     this->errorType = errorType;
 }
+
+bool FileObject::isNotModified() const
+{
+    return this->notModified;
+}
+
+void FileObject::setNotModified(bool notModified)
+{
+    this->notModified = notModified;
+}
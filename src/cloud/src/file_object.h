@@ -3,6 +3,7 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QUuid>
 
 #include <rbl_error.h>
@@ -22,8 +23,16 @@ class FileObject
         RFileInfo info;
         //! File content.
         QByteArray content;
+        //! Files holding content parts (used instead of content if not empty).
+        QStringList contentFiles;
+        //! Codec of stored content (empty if stored raw).
+        QString codec;
+        //! Checksum identifying stored content (see FileChecksum::findContentChecksum()).
+        QString contentChecksum;
         //! Error type.
         RError::Type errorType;
+        //! Conditional request was not satisfied because file was not modified.
+        bool notModified;
 
     public:
 
@@ -57,12 +66,36 @@ class FileObject
         //! Set new file content.
         void setContent(const QByteArray &content);
 
+        //! Get const reference to list of files holding content parts.
+        const QStringList &getContentFiles() const;
+
+        //! Set new list of files holding content parts.
+        void setContentFiles(const QStringList &contentFiles);
+
+        //! Get codec of stored content.
+        const QString &getCodec() const;
+
+        //! Set codec of stored content.
+        void setCodec(const QString &codec);
+
+        //! Get checksum identifying stored content.
+        const QString &getContentChecksum() const;
+
+        //! Set checksum identifying stored content.
+        void setContentChecksum(const QString &contentChecksum);
+
         //! Get error type.
         RError::Type getErrorType() const;
 
         //! Set error type.
         void setErrorType(RError::Type errorType);
 
+        //! Check if conditional request was not satisfied because file was not modified.
+        bool isNotModified() const;
+
+        //! Set if conditional request was not satisfied because file was not modified.
+        void setNotModified(bool notModified);
+
 };
 
 #endif // FILE_OBJECT_H
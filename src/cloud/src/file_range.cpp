@@ -0,0 +1,134 @@
+#include <QStringList>
+
+#include <rbl_error.h>
+
+#include "file_range.h"
+
+void FileRange::_init(const FileRange *pFileRange)
+{
+    if (pFileRange)
+    {
+        this->first = pFileRange->first;
+        this->last = pFileRange->last;
+    }
+}
+
+FileRange::FileRange()
+    : first(0)
+    , last(-1)
+{
+    this->_init();
+}
+
+FileRange::FileRange(const FileRange &fileRange)
+{
+    this->_init(&fileRange);
+}
+
+FileRange::~FileRange()
+{
+
+}
+
+FileRange &FileRange::operator =(const FileRange &fileRange)
+{
+    this->_init(&fileRange);
+    return (*this);
+}
+
+bool FileRange::resolve(qint64 fileSize, qint64 &offset, qint64 &length) const
+{
+    if (this->first < 0)
+    {
+        // Suffix range.
+        if (this->last <= 0 || fileSize <= 0)
+        {
+            return false;
+        }
+        length = qMin(this->last,fileSize);
+        offset = fileSize - length;
+        return true;
+    }
+
+    if (this->first >= fileSize)
+    {
+        return false;
+    }
+
+    qint64 lastPosition = (this->last < 0) ? fileSize - 1 : qMin(this->last,fileSize - 1);
+    offset = this->first;
+    length = lastPosition - this->first + 1;
+    return true;
+}
+
+FileRange FileRange::fromString(const QString &rangeString)
+{
+    QString spec = rangeString.trimmed();
+    if (!spec.startsWith("bytes="))
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                     "Invalid range unit in \"%s\".",
+                     rangeString.toUtf8().constData());
+    }
+    spec = spec.mid(6).trimmed();
+    if (spec.contains(','))
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                     "Multiple ranges are not supported \"%s\".",
+                     rangeString.toUtf8().constData());
+    }
+
+    qsizetype dashPosition = spec.indexOf('-');
+    if (dashPosition < 0)
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                     "Invalid range \"%s\".",
+                     rangeString.toUtf8().constData());
+    }
+
+    QString firstString = spec.left(dashPosition).trimmed();
+    QString lastString = spec.mid(dashPosition + 1).trimmed();
+
+    FileRange range;
+    bool firstOk = true;
+    bool lastOk = true;
+
+    if (firstString.isEmpty())
+    {
+        range.first = -1;
+        range.last = lastString.toLongLong(&lastOk);
+        lastOk = lastOk && range.last > 0;
+    }
+    else
+    {
+        range.first = firstString.toLongLong(&firstOk);
+        firstOk = firstOk && range.first >= 0;
+        if (!lastString.isEmpty())
+        {
+            range.last = lastString.toLongLong(&lastOk);
+            lastOk = lastOk && range.last >= range.first;
+        }
+    }
+
+    if (!firstOk || !lastOk)
+    {
+        throw RError(RError::Type::InvalidInput,R_ERROR_REF,
+                     "Invalid range \"%s\".",
+                     rangeString.toUtf8().constData());
+    }
+
+    return range;
+}
+
+QString FileRange::toString() const
+{
+    if (this->first < 0)
+    {
+        return QString("bytes=-%1").arg(this->last);
+    }
+    if (this->last < 0)
+    {
+        return QString("bytes=%1-").arg(this->first);
+    }
+    return QString("bytes=%1-%2").arg(this->first).arg(this->last);
+}
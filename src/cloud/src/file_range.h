@@ -0,0 +1,49 @@
+#ifndef FILE_RANGE_H
+#define FILE_RANGE_H
+
+#include <QString>
+
+//! Single byte range in HTTP Range syntax ("bytes=<first>-<last>", "bytes=<first>-" or "bytes=-<suffix-length>").
+class FileRange
+{
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const FileRange *pFileRange = nullptr);
+
+    protected:
+
+        //! First byte position (-1 = suffix range).
+        qint64 first;
+        //! Last byte position (-1 = till the end of file) or suffix length for suffix range.
+        qint64 last;
+
+    public:
+
+        //! Constructor.
+        FileRange();
+
+        //! Copy constructor.
+        FileRange(const FileRange &fileRange);
+
+        //! Destructor.
+        ~FileRange();
+
+        //! Assignment operator.
+        FileRange &operator =(const FileRange &fileRange);
+
+        //! Resolve range against file size.
+        //! Return false if range is not satisfiable.
+        bool resolve(qint64 fileSize, qint64 &offset, qint64 &length) const;
+
+        //! Create range from string.
+        //! Throws RError if string is not valid single byte range.
+        static FileRange fromString(const QString &rangeString);
+
+        //! Convert range to string.
+        QString toString() const;
+
+};
+
+#endif // FILE_RANGE_H
@@ -0,0 +1,291 @@
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "file_checksum.h"
+#include "file_codec.h"
+#include "file_scrubber.h"
+
+const qsizetype FileScrubber::batchSize = 100;
+
+FileScrubber::FileScrubber(const FileManagerSettings &fileManagerSettings, const FileManager *fileManager)
+    : settings{fileManagerSettings}
+    , fileManager{fileManager}
+    , stopFlag{false}
+    , budgetBytes{0}
+{
+    R_LOG_TRACE_IN;
+    this->setBlocking(false);
+    this->setParallel(true);
+    this->statistics.setName("FileScrubberService");
+    this->cursorFileName = QDir(this->settings.getFileStore()).absoluteFilePath("scrub.json");
+    R_LOG_TRACE_OUT;
+}
+
+int FileScrubber::perform()
+{
+    R_LOG_TRACE_IN;
+    try
+    {
+        this->serviceMutex.lock();
+
+        if (this->settings.getScrubBandwidth() <= 0)
+        {
+            RLogger::info("[FileScrubber] Scrubbing is disabled.\n");
+            this->serviceMutex.unlock();
+            R_LOG_TRACE_RETURN(0);
+        }
+
+        RLogger::info("[FileScrubber] Scrubbing bandwidth: %lld bytes/s, interval between passes: %u s\n",
+                      qlonglong(this->settings.getScrubBandwidth()),
+                      this->settings.getScrubInterval());
+
+        QUuid cursor = this->readCursor();
+        if (!cursor.isNull())
+        {
+            RLogger::info("[FileScrubber] Resuming scrubbing after file id=\"%s\".\n",
+                          cursor.toString(QUuid::WithoutBraces).toUtf8().constData());
+        }
+
+        this->budgetBytes = 0;
+        this->budgetTimer.start();
+
+        bool stopped = false;
+        while (!stopped)
+        {
+            const QList<FileObject> objects = this->fileManager->findStoredObjects(cursor,FileScrubber::batchSize);
+
+            // Pass is finished once all objects were scrubbed.
+            if (objects.isEmpty())
+            {
+                this->scrubOrphanFiles();
+                RLogger::info("[FileScrubber] Scrubbing pass has finished.\n");
+                this->recordStatisticsCounter("passes",1);
+                cursor = QUuid();
+                this->writeCursor(cursor);
+                stopped = !this->pause(qint64(this->settings.getScrubInterval()) * 1000);
+                this->budgetBytes = 0;
+                this->budgetTimer.restart();
+                continue;
+            }
+
+            for (const FileObject &object : objects)
+            {
+                if (!this->scrubObject(object))
+                {
+                    stopped = true;
+                    break;
+                }
+                cursor = object.getInfo().getId();
+            }
+            this->writeCursor(cursor);
+        }
+
+        this->syncMutex.lock();
+        this->stopFlag = false;
+        this->syncMutex.unlock();
+        this->serviceMutex.unlock();
+    }
+    catch (const std::exception &e)
+    {
+        RLogger::error("%s\n",e.what());
+    }
+    catch (const RError &e)
+    {
+        RLogger::error("%s\n",e.getMessage().toUtf8().constData());
+    }
+
+    R_LOG_TRACE_RETURN(0);
+}
+
+void FileScrubber::stop()
+{
+    R_LOG_TRACE_IN;
+    RLogger::info("[FileScrubber] Signal service to stop.\n");
+    this->syncMutex.lock();
+    this->stopFlag = true;
+    this->stopCondition.wakeAll();
+    this->syncMutex.unlock();
+
+    while (!this->serviceMutex.tryLock())
+    {
+        QThread::msleep(10);
+    }
+    this->serviceMutex.unlock();
+    RLogger::info("[FileScrubber] Service has been stopped.\n");
+    R_LOG_TRACE_OUT;
+}
+
+QJsonObject FileScrubber::getStatisticsJson() const
+{
+    RLogger::debug("[FileScrubber] Producting statistics\n");
+    QMutexLocker statisticsLocker(&this->statisticsMutex);
+    return this->statistics.toJson();
+}
+
+bool FileScrubber::scrubObject(const FileObject &object)
+{
+    R_LOG_TRACE_IN;
+    const RFileInfo &fileInfo = object.getInfo();
+
+    // Object may be removed or updated while it is scrubbed, problems are reported only if it was not.
+    QFile file(this->fileManager->findStoredFilePath(object));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (this->fileManager->isStoredObjectCurrent(object))
+        {
+            RLogger::error("[FileScrubber] Content of file id=\"%s\" is missing. %s.\n",
+                           fileInfo.getId().toString(QUuid::WithoutBraces).toUtf8().constData(),
+                           file.errorString().toUtf8().constData());
+            this->recordStatisticsCounter("missing",1);
+        }
+        R_LOG_TRACE_RETURN(true);
+    }
+
+    // Content is verified by the checksum it was stored with.
+    FileChecksum checksum(FileChecksum::findAlgorithm(object.getContentChecksum()));
+    qint64 size = 0;
+    bool stopped = false;
+
+    auto hashData = [&](QByteArrayView data)
+    {
+        checksum.addData(data);
+        size += data.size();
+        stopped = !this->consumeBandwidth(data.size());
+        return !stopped;
+    };
+
+    bool readFailed = false;
+    if (object.getCodec().isEmpty())
+    {
+        QByteArray buffer(qMax(this->settings.getReadBufferSize(),qint64(4096)),Qt::Uninitialized);
+        qint64 nBytes = 0;
+        while ((nBytes = file.read(buffer.data(),buffer.size())) > 0 && hashData(QByteArrayView(buffer.constData(),nBytes)))
+        {
+        }
+        readFailed = (nBytes < 0);
+    }
+    else
+    {
+        readFailed = !FileCodec::decodeFrames(file,hashData);
+    }
+    file.close();
+
+    if (stopped)
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    this->recordStatisticsCounter("scrubbed",1);
+    this->recordStatisticsCounter("scrubbed-bytes",size);
+
+    if ((readFailed ||
+         size != fileInfo.getSize() ||
+         FileChecksum::toContentChecksum(checksum.getAlgorithm(),checksum.result()) != object.getContentChecksum()) &&
+        this->fileManager->isStoredObjectCurrent(object))
+    {
+        RLogger::error("[FileScrubber] Content of file id=\"%s\" is corrupted (size \"%lld\", expected size \"%lld\", expected checksum \"%s\").\n",
+                       fileInfo.getId().toString(QUuid::WithoutBraces).toUtf8().constData(),
+                       qlonglong(size),
+                       qlonglong(fileInfo.getSize()),
+                       object.getContentChecksum().toUtf8().constData());
+        this->recordStatisticsCounter("mismatch",1);
+    }
+
+    R_LOG_TRACE_RETURN(true);
+}
+
+void FileScrubber::scrubOrphanFiles()
+{
+    R_LOG_TRACE_IN;
+    const QStringList orphanFilePaths = this->fileManager->findOrphanFiles();
+    for (const QString &orphanFilePath : orphanFilePaths)
+    {
+        RLogger::warning("[FileScrubber] Content file \"%s\" is not referenced by any file.\n",
+                         orphanFilePath.toUtf8().constData());
+    }
+    this->recordStatisticsCounter("orphan",orphanFilePaths.size());
+    R_LOG_TRACE_OUT;
+}
+
+bool FileScrubber::consumeBandwidth(qint64 nBytes)
+{
+    this->budgetBytes += nBytes;
+
+    qint64 dueTime = this->budgetBytes * 1000 / this->settings.getScrubBandwidth();
+    qint64 elapsedTime = this->budgetTimer.elapsed();
+    if (dueTime > elapsedTime)
+    {
+        return this->pause(dueTime - elapsedTime);
+    }
+
+    // Time spent idle or waiting on disk is not saved up for later bursts.
+    if (elapsedTime - dueTime > 1000)
+    {
+        this->budgetBytes = 0;
+        this->budgetTimer.restart();
+    }
+
+    return !this->isStopRequested();
+}
+
+bool FileScrubber::pause(qint64 msecs)
+{
+    QMutexLocker syncLocker(&this->syncMutex);
+    QDeadlineTimer deadline(msecs);
+    while (!this->stopFlag && !deadline.hasExpired())
+    {
+        this->stopCondition.wait(&this->syncMutex,deadline);
+    }
+    return !this->stopFlag;
+}
+
+bool FileScrubber::isStopRequested()
+{
+    QMutexLocker syncLocker(&this->syncMutex);
+    return this->stopFlag;
+}
+
+QUuid FileScrubber::readCursor() const
+{
+    QFile cursorFile(this->cursorFileName);
+    if (!cursorFile.open(QIODevice::ReadOnly))
+    {
+        return QUuid();
+    }
+    return QUuid::fromString(QJsonDocument::fromJson(cursorFile.readAll()).object()["cursor"].toString());
+}
+
+void FileScrubber::writeCursor(const QUuid &cursor) const
+{
+    if (cursor.isNull())
+    {
+        QFile::remove(this->cursorFileName);
+        return;
+    }
+
+    QJsonObject json;
+    json["cursor"] = cursor.toString(QUuid::WithoutBraces);
+
+    QSaveFile cursorFile(this->cursorFileName);
+    if (!cursorFile.open(QIODevice::WriteOnly) ||
+        cursorFile.write(QJsonDocument(json).toJson()) < 0 ||
+        !cursorFile.commit())
+    {
+        RLogger::error("[FileScrubber] Failed to write scrub cursor file \"%s\". %s.\n",
+                       this->cursorFileName.toUtf8().constData(),
+                       cursorFile.errorString().toUtf8().constData());
+    }
+}
+
+void FileScrubber::recordStatisticsCounter(const QString &key, qsizetype counter)
+{
+    QMutexLocker statisticsLocker(&this->statisticsMutex);
+    this->statistics.recordCounter(key,counter);
+}
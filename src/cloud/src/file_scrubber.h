@@ -0,0 +1,103 @@
+#ifndef FILE_SCRUBBER_H
+#define FILE_SCRUBBER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QUuid>
+#include <QWaitCondition>
+
+#include <rbl_job.h>
+
+#include "file_manager.h"
+#include "file_manager_settings.h"
+#include "service_statistics.h"
+
+//! Background job verifying stored file contents against their checksums.
+//!
+//! Objects are scrubbed in ID order, cursor of last scrubbed object is persisted
+//! so that interrupted pass is resumed after restart. Content is read within
+//! configured bandwidth so that scrubbing does not compete with requests.
+class FileScrubber : public RJob
+{
+    Q_OBJECT
+
+    public:
+
+        //! Number of objects scrubbed between cursor writes.
+        static const qsizetype batchSize;
+
+    protected:
+
+        //! File manager settings.
+        FileManagerSettings settings;
+        //! Scrubber statistics.
+        ServiceStatistics statistics;
+        //! Statistics mutex.
+        mutable QMutex statisticsMutex;
+
+        //! File manager owning the scrubbed store.
+        const FileManager *fileManager;
+
+        //! Scrub cursor file.
+        QString cursorFileName;
+
+        //! Flag signaling to stop service.
+        bool stopFlag;
+
+        QMutex syncMutex;
+        QMutex serviceMutex;
+        //! Condition signaling that stop was requested.
+        QWaitCondition stopCondition;
+
+        //! Number of bytes read since bandwidth timer was started.
+        qint64 budgetBytes;
+        //! Bandwidth timer.
+        QElapsedTimer budgetTimer;
+
+    public:
+
+        //! Constructor.
+        explicit FileScrubber(const FileManagerSettings &fileManagerSettings, const FileManager *fileManager);
+
+        //! Run scrubber.
+        virtual int perform() override final;
+
+        //! Request stop service.
+        void stop();
+
+        //! Get statistics output in Json form.
+        QJsonObject getStatisticsJson() const;
+
+    protected:
+
+        //! Verify stored content of given object.
+        //! Return false if stop was requested before the object was verified.
+        bool scrubObject(const FileObject &object);
+
+        //! Report orphaned content files.
+        void scrubOrphanFiles();
+
+        //! Account given number of read bytes and wait until they fit into bandwidth.
+        //! Return false if stop was requested.
+        bool consumeBandwidth(qint64 nBytes);
+
+        //! Wait given number of milliseconds.
+        //! Return false if stop was requested.
+        bool pause(qint64 msecs);
+
+        //! Check if stop was requested.
+        bool isStopRequested();
+
+        //! Read cursor of interrupted pass (null if there is none).
+        QUuid readCursor() const;
+
+        //! Write cursor of current pass (null cursor removes cursor file).
+        void writeCursor(const QUuid &cursor) const;
+
+        //! Record statistics counter.
+        void recordStatisticsCounter(const QString &key, qsizetype counter);
+
+};
+
+#endif // FILE_SCRUBBER_H
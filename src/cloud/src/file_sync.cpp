@@ -0,0 +1,134 @@
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "file_sync.h"
+
+const QString FileSync::Durability::None = "none";
+const QString FileSync::Durability::Operation = "operation";
+const QString FileSync::Durability::Group = "group";
+
+bool FileSync::isSupported(const QString &durability)
+{
+    return (durability == FileSync::Durability::None ||
+            durability == FileSync::Durability::Operation ||
+            durability == FileSync::Durability::Group);
+}
+
+bool FileSync::sync(const QString &path)
+{
+#ifdef Q_OS_UNIX
+    // Data of the file are flushed regardless of the descriptor they were written through.
+    int fd = ::open(QFile::encodeName(path).constData(),O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool synced = (::fsync(fd) == 0);
+    ::close(fd);
+    return synced;
+#else
+    Q_UNUSED(path);
+    return true;
+#endif
+}
+
+FileSaveFile::FileSaveFile(const QString &fileName, bool syncOnCommit)
+    : targetFileName(fileName)
+    , syncOnCommit(syncOnCommit)
+{
+
+}
+
+FileSaveFile::~FileSaveFile()
+{
+    this->cancelWriting();
+}
+
+const QString &FileSaveFile::fileName() const
+{
+    return this->targetFileName;
+}
+
+void FileSaveFile::setFileName(const QString &fileName)
+{
+    this->targetFileName = fileName;
+}
+
+bool FileSaveFile::open()
+{
+    // Temporary file is created next to the target so that it can be renamed in place.
+    this->file.setFileTemplate(this->targetFileName + ".XXXXXX");
+    this->file.setAutoRemove(true);
+    if (!this->file.open())
+    {
+        return false;
+    }
+    // Temporary files are created readable only by owner, stored file gets the usual permissions.
+    this->file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther);
+    return true;
+}
+
+bool FileSaveFile::isOpen() const
+{
+    return this->file.isOpen();
+}
+
+qint64 FileSaveFile::write(const char *data, qint64 size)
+{
+    return this->file.write(data,size);
+}
+
+qint64 FileSaveFile::write(const QByteArray &data)
+{
+    return this->file.write(data);
+}
+
+bool FileSaveFile::commit()
+{
+    if (!this->file.isOpen() || !this->file.flush())
+    {
+        this->cancelWriting();
+        return false;
+    }
+#ifdef Q_OS_UNIX
+    if (this->syncOnCommit && ::fsync(this->file.handle()) != 0)
+    {
+        this->cancelWriting();
+        return false;
+    }
+#endif
+    QString temporaryFileName = this->file.fileName();
+    this->file.close();
+#ifdef Q_OS_UNIX
+    // Existing target is replaced atomically.
+    bool renamed = (::rename(QFile::encodeName(temporaryFileName).constData(),QFile::encodeName(this->targetFileName).constData()) == 0);
+#else
+    bool renamed = ((!QFile::exists(this->targetFileName) || QFile::remove(this->targetFileName)) && QFile::rename(temporaryFileName,this->targetFileName));
+#endif
+    if (!renamed)
+    {
+        QFile::remove(temporaryFileName);
+    }
+    this->file.setAutoRemove(false);
+    return renamed;
+}
+
+void FileSaveFile::cancelWriting()
+{
+    if (this->file.isOpen())
+    {
+        // Auto removed temporary file is deleted once closed.
+        this->file.remove();
+    }
+}
+
+QString FileSaveFile::errorString() const
+{
+    return this->file.errorString();
+}
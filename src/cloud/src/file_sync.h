@@ -0,0 +1,88 @@
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <QString>
+#include <QTemporaryFile>
+
+//! Flushing of written files and directories to disk.
+class FileSync
+{
+
+    public:
+
+        //! Durability of modifying operations.
+        struct Durability
+        {
+            //! Written data are left to the operating system.
+            static const QString None;
+            //! Every operation is synced to disk before it completes.
+            static const QString Operation;
+            //! Operations completed within a time window are synced to disk together.
+            static const QString Group;
+        };
+
+    public:
+
+        //! Check if given durability is supported.
+        static bool isSupported(const QString &durability);
+
+        //! Flush file or directory with given path to disk.
+        //! Syncing directory makes files created or renamed in it durable.
+        static bool sync(const QString &path);
+
+};
+
+//! File written to temporary file in target directory and renamed in place on commit (like QSaveFile).
+//! Unlike QSaveFile, which always syncs, written data are synced to disk on commit only if requested.
+class FileSaveFile
+{
+
+    Q_DISABLE_COPY(FileSaveFile)
+
+    protected:
+
+        //! Target file name.
+        QString targetFileName;
+        //! Sync written data to disk on commit.
+        bool syncOnCommit;
+        //! Temporary file data are written to.
+        QTemporaryFile file;
+
+    public:
+
+        //! Constructor.
+        explicit FileSaveFile(const QString &fileName = QString(), bool syncOnCommit = true);
+
+        //! Destructor (removes temporary file if it was not committed).
+        ~FileSaveFile();
+
+        //! Return target file name.
+        const QString &fileName() const;
+
+        //! Set target file name.
+        void setFileName(const QString &fileName);
+
+        //! Open temporary file for writing.
+        bool open();
+
+        //! Check if temporary file is open.
+        bool isOpen() const;
+
+        //! Write data to temporary file.
+        qint64 write(const char *data, qint64 size);
+
+        //! Write data to temporary file.
+        qint64 write(const QByteArray &data);
+
+        //! Flush (and sync if requested) temporary file and rename it to target file.
+        bool commit();
+
+        //! Discard written data.
+        void cancelWriting();
+
+        //! Return description of last error.
+        QString errorString() const;
+
+};
+
+#endif // FILE_SYNC_H
@@ -0,0 +1,217 @@
+#include <QJsonArray>
+
+#include "file_upload_session.h"
+
+void FileUploadSession::_init(const FileUploadSession *pFileUploadSession)
+{
+    if (pFileUploadSession)
+    {
+        this->id = pFileUploadSession->id;
+        this->user = pFileUploadSession->user;
+        this->path = pFileUploadSession->path;
+        this->fileId = pFileUploadSession->fileId;
+        this->size = pFileUploadSession->size;
+        this->chunkSize = pFileUploadSession->chunkSize;
+        this->creationDateTime = pFileUploadSession->creationDateTime;
+        this->updateDateTime = pFileUploadSession->updateDateTime;
+        this->receivedChunks = pFileUploadSession->receivedChunks;
+    }
+}
+
+FileUploadSession::FileUploadSession()
+    : size(0)
+    , chunkSize(0)
+    , creationDateTime(0)
+    , updateDateTime(0)
+{
+    this->_init();
+}
+
+FileUploadSession::FileUploadSession(const FileUploadSession &fileUploadSession)
+{
+    this->_init(&fileUploadSession);
+}
+
+FileUploadSession::~FileUploadSession()
+{
+
+}
+
+FileUploadSession &FileUploadSession::operator =(const FileUploadSession &fileUploadSession)
+{
+    this->_init(&fileUploadSession);
+    return (*this);
+}
+
+const QUuid &FileUploadSession::getId() const
+{
+    return this->id;
+}
+
+void FileUploadSession::setId(const QUuid &id)
+{
+    this->id = id;
+}
+
+const QString &FileUploadSession::getUser() const
+{
+    return this->user;
+}
+
+void FileUploadSession::setUser(const QString &user)
+{
+    this->user = user;
+}
+
+const QString &FileUploadSession::getPath() const
+{
+    return this->path;
+}
+
+void FileUploadSession::setPath(const QString &path)
+{
+    this->path = path;
+}
+
+const QUuid &FileUploadSession::getFileId() const
+{
+    return this->fileId;
+}
+
+void FileUploadSession::setFileId(const QUuid &fileId)
+{
+    this->fileId = fileId;
+}
+
+qint64 FileUploadSession::getSize() const
+{
+    return this->size;
+}
+
+void FileUploadSession::setSize(qint64 size)
+{
+    this->size = size;
+}
+
+qint64 FileUploadSession::getChunkSize() const
+{
+    return this->chunkSize;
+}
+
+void FileUploadSession::setChunkSize(qint64 chunkSize)
+{
+    this->chunkSize = chunkSize;
+}
+
+qint64 FileUploadSession::getCreationDateTime() const
+{
+    return this->creationDateTime;
+}
+
+void FileUploadSession::setCreationDateTime(qint64 creationDateTime)
+{
+    this->creationDateTime = creationDateTime;
+}
+
+qint64 FileUploadSession::getUpdateDateTime() const
+{
+    return this->updateDateTime;
+}
+
+void FileUploadSession::setUpdateDateTime(qint64 updateDateTime)
+{
+    this->updateDateTime = updateDateTime;
+}
+
+qint64 FileUploadSession::getChunkCount() const
+{
+    if (this->chunkSize <= 0)
+    {
+        return 0;
+    }
+    return (this->size + this->chunkSize - 1) / this->chunkSize;
+}
+
+qint64 FileUploadSession::findChunkSize(qint64 index) const
+{
+    qint64 nChunks = this->getChunkCount();
+    if (index < 0 || index >= nChunks)
+    {
+        return -1;
+    }
+    if (index == nChunks - 1)
+    {
+        return this->size - index * this->chunkSize;
+    }
+    return this->chunkSize;
+}
+
+void FileUploadSession::setChunkReceived(qint64 index)
+{
+    this->receivedChunks.insert(index);
+}
+
+bool FileUploadSession::isChunkReceived(qint64 index) const
+{
+    return this->receivedChunks.contains(index);
+}
+
+bool FileUploadSession::isComplete() const
+{
+    return this->receivedChunks.size() == this->getChunkCount();
+}
+
+FileUploadSession FileUploadSession::fromJson(const QJsonObject &json)
+{
+    FileUploadSession session;
+
+    session.id = QUuid::fromString(json["id"].toString());
+    session.user = json["user"].toString();
+    session.path = json["path"].toString();
+    session.fileId = QUuid::fromString(json["fileId"].toString());
+    session.size = json["size"].toString().toLongLong();
+    session.chunkSize = json["chunkSize"].toString().toLongLong();
+    session.creationDateTime = json["created"].toString().toLongLong();
+    session.updateDateTime = json["updated"].toString().toLongLong();
+
+    return session;
+}
+
+QJsonObject FileUploadSession::toJson(bool withChunks) const
+{
+    QJsonObject json;
+
+    json["id"] = this->id.toString(QUuid::WithoutBraces);
+    json["user"] = this->user;
+    json["path"] = this->path;
+    if (!this->fileId.isNull())
+    {
+        json["fileId"] = this->fileId.toString(QUuid::WithoutBraces);
+    }
+    json["size"] = QString::number(this->size);
+    json["chunkSize"] = QString::number(this->chunkSize);
+    json["chunks"] = QString::number(this->getChunkCount());
+    json["created"] = QString::number(this->creationDateTime);
+    json["updated"] = QString::number(this->updateDateTime);
+
+    if (withChunks)
+    {
+        QJsonArray receivedArray;
+        QJsonArray missingArray;
+        for (qint64 index=0;index<this->getChunkCount();index++)
+        {
+            if (this->receivedChunks.contains(index))
+            {
+                receivedArray.append(index);
+            }
+            else
+            {
+                missingArray.append(index);
+            }
+        }
+        json["received"] = receivedArray;
+        json["missing"] = missingArray;
+    }
+
+    return json;
+}
@@ -0,0 +1,123 @@
+#ifndef FILE_UPLOAD_SESSION_H
+#define FILE_UPLOAD_SESSION_H
+
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QUuid>
+
+class FileUploadSession
+{
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const FileUploadSession *pFileUploadSession = nullptr);
+
+    protected:
+
+        //! Session ID.
+        QUuid id;
+        //! User who opened the session.
+        QString user;
+        //! Path of uploaded file.
+        QString path;
+        //! ID of updated file (null when new file is stored).
+        QUuid fileId;
+        //! Total file size.
+        qint64 size;
+        //! Chunk size.
+        qint64 chunkSize;
+        //! Session creation time (seconds since epoch).
+        qint64 creationDateTime;
+        //! Time of last session activity (seconds since epoch).
+        qint64 updateDateTime;
+        //! Indexes of received chunks.
+        QSet<qint64> receivedChunks;
+
+    public:
+
+        //! Constructor.
+        FileUploadSession();
+
+        //! Copy constructor.
+        FileUploadSession(const FileUploadSession &fileUploadSession);
+
+        //! Destructor.
+        ~FileUploadSession();
+
+        //! Assignment operator.
+        FileUploadSession &operator =(const FileUploadSession &fileUploadSession);
+
+        //! Get session ID.
+        const QUuid &getId() const;
+
+        //! Set session ID.
+        void setId(const QUuid &id);
+
+        //! Get user who opened the session.
+        const QString &getUser() const;
+
+        //! Set user who opened the session.
+        void setUser(const QString &user);
+
+        //! Get path of uploaded file.
+        const QString &getPath() const;
+
+        //! Set path of uploaded file.
+        void setPath(const QString &path);
+
+        //! Get ID of updated file.
+        const QUuid &getFileId() const;
+
+        //! Set ID of updated file.
+        void setFileId(const QUuid &fileId);
+
+        //! Get total file size.
+        qint64 getSize() const;
+
+        //! Set total file size.
+        void setSize(qint64 size);
+
+        //! Get chunk size.
+        qint64 getChunkSize() const;
+
+        //! Set chunk size.
+        void setChunkSize(qint64 chunkSize);
+
+        //! Get session creation time.
+        qint64 getCreationDateTime() const;
+
+        //! Set session creation time.
+        void setCreationDateTime(qint64 creationDateTime);
+
+        //! Get time of last session activity.
+        qint64 getUpdateDateTime() const;
+
+        //! Set time of last session activity.
+        void setUpdateDateTime(qint64 updateDateTime);
+
+        //! Return number of chunks.
+        qint64 getChunkCount() const;
+
+        //! Return expected size of chunk with given index.
+        qint64 findChunkSize(qint64 index) const;
+
+        //! Mark chunk as received.
+        void setChunkReceived(qint64 index);
+
+        //! Check if chunk was received.
+        bool isChunkReceived(qint64 index) const;
+
+        //! Check if all chunks were received.
+        bool isComplete() const;
+
+        //! Create session from Json.
+        static FileUploadSession fromJson(const QJsonObject &json);
+
+        //! Create Json from session (includes received and missing chunks if requested).
+        QJsonObject toJson(bool withChunks = false) const;
+
+};
+
+#endif // FILE_UPLOAD_SESSION_H
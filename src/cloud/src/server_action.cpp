@@ -0,0 +1,57 @@
+#include "server_action.h"
+
+const QString ServerAction::FileUploadOpen::key = "file-upload-open";
+const QString ServerAction::FileUploadOpen::description = "Open resumable file upload session";
+
+const QString ServerAction::FileUploadChunk::key = "file-upload-chunk";
+const QString ServerAction::FileUploadChunk::description = "Upload file chunk to upload session";
+
+const QString ServerAction::FileUploadStatus::key = "file-upload-status";
+const QString ServerAction::FileUploadStatus::description = "Get status of upload session";
+
+const QString ServerAction::FileUploadCommit::key = "file-upload-commit";
+const QString ServerAction::FileUploadCommit::description = "Commit upload session";
+
+const QString ServerAction::FileUploadAbort::key = "file-upload-abort";
+const QString ServerAction::FileUploadAbort::description = "Abort upload session";
+
+const QString ServerAction::FileBatchRemove::key = "file-batch-remove";
+const QString ServerAction::FileBatchRemove::description = "Remove multiple files";
+
+const QString ServerAction::FileBatchUpdateAccessMode::key = "file-batch-update-access-mode";
+const QString ServerAction::FileBatchUpdateAccessMode::description = "Update access mode of multiple files";
+
+const QString ServerAction::FileBatchUpdateVersion::key = "file-batch-update-version";
+const QString ServerAction::FileBatchUpdateVersion::description = "Update version of multiple files";
+
+const QString ServerAction::FileBatchUpdateTags::key = "file-batch-update-tags";
+const QString ServerAction::FileBatchUpdateTags::description = "Update tags of multiple files";
+
+const QString ServerAction::FileDownloadArchive::key = "file-download-archive";
+const QString ServerAction::FileDownloadArchive::description = "Download multiple files as tar archive";
+
+const QString ServerAction::FileUploadArchive::key = "file-upload-archive";
+const QString ServerAction::FileUploadArchive::description = "Upload tar archive and store its members as files";
+
+const QString ServerAction::FileMd5Checksum::key = "file-md5-checksum";
+const QString ServerAction::FileMd5Checksum::description = "Get file information with MD5 checksum";
+
+QMap<QString,QString> ServerAction::getActionMap()
+{
+    QMap<QString,QString> actionMap;
+
+    actionMap.insert(ServerAction::FileUploadOpen::key,ServerAction::FileUploadOpen::description);
+    actionMap.insert(ServerAction::FileUploadChunk::key,ServerAction::FileUploadChunk::description);
+    actionMap.insert(ServerAction::FileUploadStatus::key,ServerAction::FileUploadStatus::description);
+    actionMap.insert(ServerAction::FileUploadCommit::key,ServerAction::FileUploadCommit::description);
+    actionMap.insert(ServerAction::FileUploadAbort::key,ServerAction::FileUploadAbort::description);
+    actionMap.insert(ServerAction::FileBatchRemove::key,ServerAction::FileBatchRemove::description);
+    actionMap.insert(ServerAction::FileBatchUpdateAccessMode::key,ServerAction::FileBatchUpdateAccessMode::description);
+    actionMap.insert(ServerAction::FileBatchUpdateVersion::key,ServerAction::FileBatchUpdateVersion::description);
+    actionMap.insert(ServerAction::FileBatchUpdateTags::key,ServerAction::FileBatchUpdateTags::description);
+    actionMap.insert(ServerAction::FileDownloadArchive::key,ServerAction::FileDownloadArchive::description);
+    actionMap.insert(ServerAction::FileUploadArchive::key,ServerAction::FileUploadArchive::description);
+    actionMap.insert(ServerAction::FileMd5Checksum::key,ServerAction::FileMd5Checksum::description);
+
+    return actionMap;
+}
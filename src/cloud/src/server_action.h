@@ -0,0 +1,92 @@
+#ifndef SERVER_ACTION_H
+#define SERVER_ACTION_H
+
+#include <QMap>
+#include <QString>
+
+//! Actions provided by this server in addition to RCloudAction actions.
+class ServerAction
+{
+
+    public:
+
+        struct FileUploadOpen
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileUploadChunk
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileUploadStatus
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileUploadCommit
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileUploadAbort
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileBatchRemove
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileBatchUpdateAccessMode
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileBatchUpdateVersion
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileBatchUpdateTags
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileDownloadArchive
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileUploadArchive
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+        struct FileMd5Checksum
+        {
+            static const QString key;
+            static const QString description;
+        };
+
+    public:
+
+        //! Return map of action keys and descriptions.
+        static QMap<QString,QString> getActionMap();
+
+};
+
+#endif // SERVER_ACTION_H